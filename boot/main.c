@@ -27,6 +27,20 @@
 #undef max
 #endif
 
+// ------------------------ Clock configuration ------------------------
+
+// CPU clock for cycle->time conversion, exported by the SoC in generated/soc.h
+// (litex_sim --sys-clk-freq keeps the simulator clocker in sync with it).
+#ifdef CONFIG_CLOCK_FREQUENCY
+#define CPU_HZ             ((uint32_t)CONFIG_CLOCK_FREQUENCY)
+#else
+#define CPU_HZ             1000000u
+#endif
+
+// Deployment clocks the measured cycle counts are projected onto.
+#define DEPLOY_HZ_LOW      50000000u
+#define DEPLOY_HZ_HIGH     100000000u
+
 // ------------------------ Network configuration ------------------------
 
 #ifdef CSR_ETHMAC_BASE
@@ -61,12 +75,29 @@
 
 // DTLS settings
 #define DTLS_MTU           1200
+#define DTLS_ACK_DELAY_MS  20     // records arriving this close share one ACK
+// 1 holds writes for the ACK delay too, so the writes made meanwhile share one
+// record. The demo writes once and then waits for the echo, so holding would
+// only add latency.
+#define DTLS_HOLD_WRITES   0
+// CCM-8 first: its 8-byte tag halves the AEAD overhead of each telemetry
+// record. The fleet server decides; its default list only has AES-GCM.
+#define DTLS_CIPHERS       "TLS13-AES128-CCM-8-SHA256:TLS13-AES128-GCM-SHA256"
+// Key share in the first ClientHello: the cheapest group the fleet server
+// accepts without a HelloRetryRequest (mlkem512 in host/conf/dilithium.conf).
+// Nothing survives a reset to remember the server's choice in a session, so
+// it is fixed at build time. 0 sends wolfSSL's default P-256 share instead.
+#define DTLS_KEY_SHARE     WOLFSSL_ML_KEM_512
 #define DTLS_MAX_RX        1600
 #define DTLS_APP_MSG       "Hello from LiteX PQC-DTLS 1.3 client"
-#define CPU_HZ_EST         1000000u  // approximate CPU clock for cycle->time conversion
+
+// Simulation markers (SimMarker CSR, litex_sim --sim-debug). The simulator can
+// snapshot the whole SoC when a marker is set and restart from there:
+//   first run:   litex_sim ... --sim-debug --save-marker=1
+//   later runs:  litex_sim ... --sim-debug --load-snapshot
+#define SIM_MARKER_KEYS_LOADED 1  // boot, ARP and certificate/key parsing done
 
 static uint64_t g_hs_cycles = 0;
-static uint64_t g_hs_ms     = 0;
 static uint64_t g_data_cycles = 0;
 static uint64_t g_data_ms     = 0;
 static uint32_t g_data_bytes  = 0;
@@ -173,6 +204,21 @@ static uint64_t cycle_count(void)
 #endif
 }
 
+static uint64_t cycles_to_ms(uint64_t cycles, uint32_t hz)
+{
+    return (hz > 0u) ? (cycles * 1000u / hz) : 0u;
+}
+
+static void print_cycles(const char *label, uint64_t cycles)
+{
+    printf("%s: %llu cycles (~%llu ms at %u Hz; ~%llu ms at %u MHz, ~%llu ms at %u MHz)\n",
+           label,
+           (unsigned long long)cycles,
+           (unsigned long long)cycles_to_ms(cycles, CPU_HZ), (unsigned)CPU_HZ,
+           (unsigned long long)cycles_to_ms(cycles, DEPLOY_HZ_LOW), (unsigned)(DEPLOY_HZ_LOW / 1000000u),
+           (unsigned long long)cycles_to_ms(cycles, DEPLOY_HZ_HIGH), (unsigned)(DEPLOY_HZ_HIGH / 1000000u));
+}
+
 static uintptr_t span_bytes(const char* start, const char* end)
 {
     if (start == NULL || end == NULL)
@@ -246,13 +292,20 @@ typedef struct {
 
 static int dtls_io_recv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
 {
-    (void)ssl;
     (void)ctx;
 
+    // wolfSSL asks for the quick timeout while it holds back ACKs or writes;
+    // waiting only the ACK delay then lets them go out together.
+    uint64_t quick_end = 0;
+    if (wolfSSL_dtls13_use_quick_timeout(ssl))
+        quick_end = cycle_count() + (uint64_t)DTLS_ACK_DELAY_MS * (CPU_HZ / 1000u);
+
     for (uint32_t i = 0; i < DTLS_IO_TIMEOUT_LOOPS; ++i) {
         udp_service();
         if (g_rx.ready)
             break;
+        if (quick_end != 0 && cycle_count() >= quick_end)
+            break;
     }
 
     if (!g_rx.ready) {
@@ -359,6 +412,24 @@ static int run_dtls13_demo(void)
         return -1;
     }
 
+#ifdef HAVE_RPK
+    // 1. Raw public keys (RFC 7250): both ends send a bare SubjectPublicKeyInfo
+    // and the server key is pinned, so no CA and no X.509 chain are involved.
+    static const char rpk_only[] = { WOLFSSL_CERT_TYPE_RPK };
+    printf("Loading Dilithium raw public keys (%u-byte client key, %u-byte server pin)...\n",
+           client_rpk_dilithium_der_len, server_rpk_dilithium_der_len);
+    if (wolfSSL_CTX_set_client_cert_type(ctx, rpk_only, 1) != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_set_server_cert_type(ctx, rpk_only, 1) != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_use_certificate_buffer(ctx, client_rpk_dilithium_der, client_rpk_dilithium_der_len, WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_add_rpk_pin(ctx, server_rpk_dilithium_der, (int)server_rpk_dilithium_der_len) != WOLFSSL_SUCCESS) {
+        printf("Failed to load raw public keys\n");
+        wolfSSL_CTX_free(ctx);
+        udp_set_callback(NULL);
+        wolfSSL_Cleanup();
+        return -1;
+    }
+    printf("Raw public key mode, server key pinned.\n");
+#else
     // 1. Load CA Certificate to verify Server (Dilithium)
     printf("Loading Dilithium CA certificate (%u bytes)...\n", ca_cert_dilithium_der_len);
     if (wolfSSL_CTX_load_verify_buffer(ctx, ca_cert_dilithium_der, ca_cert_dilithium_der_len, WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS) {
@@ -370,6 +441,35 @@ static int run_dtls13_demo(void)
     }
     printf("Dilithium CA certificate loaded successfully.\n");
 
+#ifdef HAVE_CERT_COMPRESSION
+    // Both ends hold the CA, so it doubles as the certificate dictionary.
+    if (wolfSSL_CTX_set_cert_compress_dict(ctx, ca_cert_dilithium_der, ca_cert_dilithium_der_len) != WOLFSSL_SUCCESS) {
+        printf("Failed to set certificate compression dictionary\n");
+        wolfSSL_CTX_free(ctx);
+        udp_set_callback(NULL);
+        wolfSSL_Cleanup();
+        return -1;
+    }
+    printf("Certificate compression enabled (CA dictionary).\n");
+#endif
+
+#ifdef HAVE_CACHED_INFO
+    // The server certificate ships with the firmware: the server sends only
+    // its hash, and as a trusted peer it is not verified again on every boot.
+    if (wolfSSL_CTX_UseCachedCert(ctx, server_cert_dilithium_der, server_cert_dilithium_der_len) != WOLFSSL_SUCCESS
+#ifdef WOLFSSL_TRUST_PEER_CERT
+        || wolfSSL_CTX_trust_peer_buffer(ctx, server_cert_dilithium_der, server_cert_dilithium_der_len, WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS
+#endif
+        ) {
+        printf("Failed to load the cached server certificate\n");
+        wolfSSL_CTX_free(ctx);
+        udp_set_callback(NULL);
+        wolfSSL_Cleanup();
+        return -1;
+    }
+    printf("Server certificate cached (%u bytes), sent as a hash.\n", server_cert_dilithium_der_len);
+#endif
+
     // 2. Load Client Certificate & Private Key for Mutual Auth (Dilithium)
     printf("Loading Dilithium client certificate (%u bytes)...\n", client_cert_dilithium_der_len);
     if (wolfSSL_CTX_use_certificate_buffer(ctx, client_cert_dilithium_der, client_cert_dilithium_der_len, WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS) {
@@ -380,6 +480,7 @@ static int run_dtls13_demo(void)
         return -1;
     }
     printf("Dilithium client certificate loaded successfully.\n");
+#endif /* HAVE_RPK */
     
     printf("Loading Dilithium client private key (%u bytes)...\n", client_key_dilithium_der_len);
     if (wolfSSL_CTX_use_PrivateKey_buffer(ctx, client_key_dilithium_der, client_key_dilithium_der_len, WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS) {
@@ -390,6 +491,9 @@ static int run_dtls13_demo(void)
         return -1;
     }
     printf("Dilithium client private key loaded successfully.\n");
+#ifdef CSR_SIM_MARKER_BASE
+    sim_marker_marker_write(SIM_MARKER_KEYS_LOADED);
+#endif
 
     // 3. Enable Mutual Authentication (ignore bad time since no RTC on target)
     wolfSSL_CTX_set_verify(ctx,
@@ -397,9 +501,9 @@ static int run_dtls13_demo(void)
         verify_allow_badtime);
     printf("Mutual authentication enabled with PQC (time validity ignored).\n");
 
-    // 4. Set Cipher Suite (TLS 1.3)
-    wolfSSL_CTX_set_cipher_list(ctx, "TLS13-AES128-GCM-SHA256");
-    printf("Cipher suite set to TLS13-AES128-GCM-SHA256.\n");
+    // 4. Set Cipher Suites (TLS 1.3)
+    wolfSSL_CTX_set_cipher_list(ctx, DTLS_CIPHERS);
+    printf("Cipher suites set to %s.\n", DTLS_CIPHERS);
     
 #ifdef HAVE_PQC
     printf("Post-Quantum Key Exchange enabled (Kyber).\n");
@@ -423,6 +527,18 @@ static int run_dtls13_demo(void)
     dtls_net_ctx_t net = {.peer_ip = kRemoteIp, .peer_port = DTLS_SERVER_PORT};
     wolfSSL_SetIOReadCtx(ssl, &net);
     wolfSSL_SetIOWriteCtx(ssl, &net);
+    wolfSSL_dtls13_set_ack_delay(ssl, DTLS_ACK_DELAY_MS);
+    // Hold each record until its flight is complete, then send the flight as
+    // few MTU sized datagrams: Certificate, CertificateVerify and Finished
+    // leave in one frame instead of three.
+    wolfSSL_set_group_messages(ssl);
+    // Application data goes out with an 8-bit sequence number and, alone in
+    // its datagram, without a length: 3 bytes less per record.
+    wolfSSL_dtls13_set_short_header(ssl, 1);
+    if (DTLS_HOLD_WRITES)
+        wolfSSL_dtls13_set_write_delay(ssl, DTLS_ACK_DELAY_MS);
+    if (DTLS_KEY_SHARE != 0 && wolfSSL_UseKeyShare(ssl, DTLS_KEY_SHARE) != WOLFSSL_SUCCESS)
+        printf("Predicted key share unavailable, sending the default\n");
     
     printf("Starting DTLS 1.3 handshake with Dilithium PQC certificates...\n");
     uint64_t hs_start_cycles = cycle_count();
@@ -460,17 +576,20 @@ static int run_dtls13_demo(void)
     }
     uint64_t hs_end_cycles = cycle_count();
     uint64_t hs_cycles = hs_end_cycles - hs_start_cycles;
-    uint64_t hs_ms = (CPU_HZ_EST > 0u) ? (hs_cycles * 1000u / CPU_HZ_EST) : 0u;
     g_hs_cycles = hs_cycles;
-    g_hs_ms = hs_ms;
     g_pqc_cycles = hs_cycles; // PQC key exchange is part of the handshake
     g_heap_after_hs = heap_usage_bytes();
-    printf("Handshake complete in %llu cycles (~%llu ms at %u Hz).\n",
-           (unsigned long long)hs_cycles,
-           (unsigned long long)hs_ms,
-           CPU_HZ_EST);
+    print_cycles("Handshake complete", hs_cycles);
     printf("Negotiated Cipher: %s\n", wolfSSL_get_cipher(ssl));
     printf("Negotiated Version: %s\n", wolfSSL_get_version(ssl));
+    const char* kx_group = wolfSSL_get_curve_name(ssl);
+    printf("Key exchange group: %s\n", kx_group != NULL ? kx_group : "unknown");
+#ifdef WOLFSSL_DTLS13_RTX_STATS
+    unsigned int rtx_timeouts = 0, rtx_records = 0, rtx_bytes = 0, rtx_acked = 0;
+    if (wolfSSL_dtls13_get_rtx_stats(ssl, &rtx_timeouts, &rtx_records, &rtx_bytes, &rtx_acked) == WOLFSSL_SUCCESS)
+        printf("Retransmissions: %u records (%u bytes), %u timeouts, %u records ACKed\n",
+               rtx_records, rtx_bytes, rtx_timeouts, rtx_acked);
+#endif
 
     // Send application data
     const char app_msg[] = DTLS_APP_MSG;
@@ -487,11 +606,18 @@ static int run_dtls13_demo(void)
     }
     printf("Sent %d bytes of application data.\n", ret);
 
-    // Wait for echo from server
+    // Wait for echo from server. A read times out with WANT_READ after the
+    // quick timeout that sends held ACKs or writes; keep waiting then.
     uint8_t rx_buf[DTLS_MAX_RX];
-    ret = wolfSSL_read(ssl, rx_buf, sizeof(rx_buf));
-    if (ret < 0) {
+    attempts = 0;
+    for (;;) {
+        ret = wolfSSL_read(ssl, rx_buf, sizeof(rx_buf));
+        if (ret > 0)
+            break;
         int err = wolfSSL_get_error(ssl, ret);
+        if ((err == WOLFSSL_ERROR_WANT_READ || err == WOLFSSL_ERROR_WANT_WRITE) &&
+            ++attempts < kMaxAttempts)
+            continue;
         printf("wolfSSL_read failed: %d\n", err);
         wolfSSL_free(ssl);
         wolfSSL_CTX_free(ctx);
@@ -501,7 +627,7 @@ static int run_dtls13_demo(void)
     }
     uint64_t data_end_cycles = cycle_count();
     g_data_cycles = data_end_cycles - data_start_cycles;
-    g_data_ms = (CPU_HZ_EST > 0u) ? (g_data_cycles * 1000u / CPU_HZ_EST) : 0u;
+    g_data_ms = cycles_to_ms(g_data_cycles, CPU_HZ);
     g_data_bytes = (uint32_t)ret;
     g_heap_after_app = heap_usage_bytes();
 
@@ -535,10 +661,7 @@ int main(void)
     printf("DEBUG: run_dtls13_demo returned with status: %d\n", status);
     printf("Demo %s.\n", (status == 0) ? "PASSED" : "FAILED");
     if (status == 0 && g_hs_cycles > 0) {
-        printf("Handshake duration (client): %llu cycles (~%llu ms at %u Hz)\n",
-               (unsigned long long)g_hs_cycles,
-               (unsigned long long)g_hs_ms,
-               CPU_HZ_EST);
+        print_cycles("Handshake duration (client)", g_hs_cycles);
         printf("PQC key exchange cycles (within handshake): %llu cycles\n",
                (unsigned long long)g_pqc_cycles);
     }
@@ -103,11 +103,11 @@ typedef struct Dtls13RecordPlaintextHeader {
 /* Length field is present if this bit is into unified header flags */
 #define DTLS13_LEN_BIT (0x1 << 2)
 
-/* For now, the size of the outgoing DTLSv1.3 record header is fixed to 5 bytes
-   (8 bit header flags + 16bit record number + 16 bit length). In the future, we
-   can dynamically choose to remove the length from the header to save
-   space. Also it will need to account for client connection ID when
-   supported. */
+/* The outgoing DTLSv1.3 record header is 5 bytes (8 bit header flags + 16bit
+   record number + 16 bit length) plus the connection ID. Application data
+   with wolfSSL_dtls13_set_short_header() on drops it to an 8 bit record
+   number, and leaves the length out when the record ends its datagram, see
+   Dtls13GetAppDataHeaderLength(). */
 #define DTLS13_UNIFIED_HEADER_SIZE 5
 #define DTLS13_MIN_CIPHERTEXT 16
 #define DTLS13_MIN_RTX_INTERVAL 1
@@ -226,6 +226,7 @@ static byte Dtls13TypeIsEncrypted(enum HandShakeType hs_type)
     case session_ticket:
     case end_of_early_data:
     case certificate:
+    case compressed_certificate:
     case server_key_exchange:
     case certificate_request:
     case server_hello_done:
@@ -473,7 +474,7 @@ static int Dtls13SendFragFromBuffer(WOLFSSL* ssl, byte* output, word16 length)
 static int Dtls13SendNow(WOLFSSL* ssl, enum HandShakeType handshakeType)
 {
     printf("Entering Dtls13SendNow\n");
-    if (!ssl->options.groupMessages || ssl->dtls13SendingFragments)
+    if (!ssl->options.groupMessages)
         return 1;
 
     if (handshakeType == client_hello || handshakeType == hello_retry_request ||
@@ -631,7 +632,6 @@ static WC_INLINE void Dtls13FreeRtxBufferRecord(WOLFSSL* ssl,
     printf("Entering Dtls13FreeRtxBufferRecord\n");
     (void)ssl;
 
-    XFREE(r->data, ssl->heap, DYNAMIC_TYPE_DTLS_MSG);
     XFREE(r, ssl->heap, DYNAMIC_TYPE_DTLS_MSG);
 }
 
@@ -650,19 +650,15 @@ static Dtls13RtxRecord* Dtls13RtxNewRecord(WOLFSSL* ssl, byte* data,
 
     epochNumber = ssl->dtls13EncryptEpoch->epochNumber;
 
-    r = (Dtls13RtxRecord*)XMALLOC(sizeof(*r), ssl->heap, DYNAMIC_TYPE_DTLS_MSG);
+    /* One allocation: the record followed by its payload. */
+    r = (Dtls13RtxRecord*)XMALLOC(sizeof(*r) + length, ssl->heap,
+        DYNAMIC_TYPE_DTLS_MSG);
     if (r == NULL){
         printf("r is null\n");
         return NULL;
     }
 
-    r->data = (byte*)XMALLOC(length, ssl->heap, DYNAMIC_TYPE_DTLS_MSG);
-    if (r->data == NULL) {
-        XFREE(r, ssl->heap, DYNAMIC_TYPE_DTLS_MSG);
-        printf("r -> data is null");
-        return NULL;
-    }
-
+    r->data = (byte*)(r + 1);
     XMEMCPY(r->data, data, length);
     r->epoch = epochNumber;
     r->length = length;
@@ -839,12 +835,11 @@ static int Dtls13DetectDisruption(WOLFSSL* ssl, word32 fragOffset)
        in the worst case, we don't detect the disruption and wait for the other
        peer retransmission) */
     if (ssl->dtls_rx_msg_list != NULL) {
-        DtlsFragBucket* last = ssl->dtls_rx_msg_list->fragBucketList;
-        while (last != NULL && last->m.m.next != NULL)
-            last = last->m.m.next;
+        DtlsMsg* msg = ssl->dtls_rx_msg_list;
         /* Does this fragment start right after the last fragment we
          * have stored? */
-        if (last != NULL && (last->m.m.offset + last->m.m.sz) != fragOffset)
+        if (msg->rxRangeCnt > 0 &&
+                msg->rxRanges[msg->rxRangeCnt - 1][1] != fragOffset)
             return 1;
     }
     else {
@@ -891,10 +886,11 @@ static void Dtls13MaybeSaveClientHello(WOLFSSL* ssl)
             if (r->handshakeType == client_hello) {
                 Dtls13RtxRecordUnlink(ssl, prev_next, r);
                 XFREE(ssl->dtls13ClientHello, ssl->heap, DYNAMIC_TYPE_DTLS_MSG);
-                ssl->dtls13ClientHello = r->data;
+                /* Keep the record's block: slide the payload to its start. */
                 ssl->dtls13ClientHelloSz = r->length;
-                r->data = NULL;
-                Dtls13FreeRtxBufferRecord(ssl, r);
+                ssl->dtls13ClientHello = (byte*)r;
+                XMEMMOVE(ssl->dtls13ClientHello, r->data,
+                    ssl->dtls13ClientHelloSz);
                 return;
             }
             prev_next = &r->next;
@@ -968,6 +964,10 @@ static int Dtls13RtxMsgRecvd(WOLFSSL* ssl, enum HandShakeType hs,
 
 void Dtls13FreeFsmResources(WOLFSSL* ssl)
 {
+    XFREE(ssl->dtls13HeldWrites.buffer, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    ssl->dtls13HeldWrites.buffer = NULL;
+    ssl->dtls13HeldWrites.length = 0;
+    ssl->dtls13HeldWritesSz = 0;
     Dtls13RtxFlushAcks(ssl);
     /* Use 1.2 API to clear 1.2 buffers too */
     DtlsMsgPoolReset(ssl);
@@ -976,7 +976,7 @@ void Dtls13FreeFsmResources(WOLFSSL* ssl)
 
 static int Dtls13SendOneFragmentRtx(WOLFSSL* ssl,
     enum HandShakeType handshakeType, word16 outputSize, byte* message,
-    word32 length, int hashOutput)
+    word32 length, int hashOutput, int sendImmediately)
 {
     Dtls13RtxRecord* rtxRecord = NULL;
     word16 recordHeaderLength;
@@ -997,7 +997,7 @@ static int Dtls13SendOneFragmentRtx(WOLFSSL* ssl,
     }
 
     ret = Dtls13SendFragment(ssl, message, outputSize, (word16)length,
-        handshakeType, hashOutput, Dtls13SendNow(ssl, handshakeType));
+        handshakeType, hashOutput, sendImmediately);
 
     printf("before rtx != null function\n");
     if (rtxRecord != NULL) {
@@ -1060,9 +1060,14 @@ static int Dtls13SendFragmentedInternal(WOLFSSL* ssl)
             ssl->dtls13FragmentsBuffer.buffer + ssl->dtls13FragOffset,
             fragLength);
 
+        /* a full fragment fills the datagram on its own; the tail of the
+           message is grouped with the records that follow it like any other
+           small record */
         ret = Dtls13SendOneFragmentRtx(ssl,
             (enum HandShakeType)ssl->dtls13FragHandshakeType,
-            (word16)recordLength + MAX_MSG_EXTRA, output, (word32)recordLength, 0);
+            (word16)recordLength + MAX_MSG_EXTRA, output, (word32)recordLength, 0,
+            fragLength < remainingSize || Dtls13SendNow(ssl,
+                (enum HandShakeType)ssl->dtls13FragHandshakeType));
         if (ret == WC_NO_ERR_TRACE(WANT_WRITE)) {
             ssl->dtls13FragOffset += fragLength;
             return ret;
@@ -1208,13 +1213,41 @@ int Dtls13UnifiedHeaderCIDPresent(byte flags)
 #define Dtls13UnifiedHeaderParseCID(a, b, c, d, e) 0
 #endif /* WOLFSSL_DTLS_CID */
 
+/**
+ * Dtls13GetAppDataHeaderLength() - record header length for application data
+ * @ssl: ssl object
+ *
+ * With the short header on, application data after the handshake carries an
+ * 8-bit sequence number. When nothing else waits in the output buffer the
+ * record also goes without a length: SendData() sends each record as soon as
+ * it is built, so it ends its datagram, and CheckAvailableSize() sends it
+ * before anything else is queued behind it.
+ */
+word16 Dtls13GetAppDataHeaderLength(WOLFSSL* ssl)
+{
+    word16 length = Dtls13GetRlHeaderLength(ssl, 1);
+
+    if (!ssl->options.dtls13ShortHeader || !ssl->options.handShakeDone)
+        return length;
+
+    length -= DTLS13_SEQ_16_LEN - DTLS13_SEQ_8_LEN;
+    if (ssl->buffers.outputBuffer.length == 0)
+        length -= DTLS13_LEN_SIZE;
+
+    return length;
+}
+
 /**
  * dtls13RlAddCiphertextHeader() - add record layer header in the buffer
  * @ssl: ssl object
  * @out: output buffer where to put the header
  * @length: length of the record
+ * @headerLength: from Dtls13GetRlHeaderLength() or
+ *  Dtls13GetAppDataHeaderLength(). The fields that do not fit are left out:
+ *  first the high byte of the sequence number, then the length.
  */
-int Dtls13RlAddCiphertextHeader(WOLFSSL* ssl, byte* out, word16 length)
+int Dtls13RlAddCiphertextHeader(WOLFSSL* ssl, byte* out, word16 length,
+    word16 headerLength)
 {
     word16 seqNumber, idx;
     byte* flags;
@@ -1238,15 +1271,24 @@ int Dtls13RlAddCiphertextHeader(WOLFSSL* ssl, byte* out, word16 length)
     if (ret != 0)
         return ret;
 
-    /* include 16-bit seq */
-    *flags |= DTLS13_SEQ_LEN_BIT;
-    /* include 16-bit length */
-    *flags |= DTLS13_LEN_BIT;
-
     seqNumber = (word16)w64GetLow32(ssl->dtls13EncryptEpoch->nextSeqNumber);
-    c16toa(seqNumber, out + idx);
-    idx += OPAQUE16_LEN;
-    c16toa(length, out + idx);
+    if (headerLength < idx + DTLS13_SEQ_16_LEN + DTLS13_LEN_SIZE) {
+        /* 8-bit seq */
+        out[idx] = (byte)seqNumber;
+        idx += DTLS13_SEQ_8_LEN;
+    }
+    else {
+        /* include 16-bit seq */
+        *flags |= DTLS13_SEQ_LEN_BIT;
+        c16toa(seqNumber, out + idx);
+        idx += DTLS13_SEQ_16_LEN;
+    }
+
+    if (idx < headerLength) {
+        /* include 16-bit length */
+        *flags |= DTLS13_LEN_BIT;
+        c16toa(length, out + idx);
+    }
 
     return 0;
 }
@@ -1276,9 +1318,9 @@ int Dtls13HandshakeAddHeader(WOLFSSL* ssl, byte* output,
     return 0;
 }
 
-int Dtls13MinimumRecordLength(WOLFSSL* ssl)
+int Dtls13MinimumRecordLength(word16 headerLength)
 {
-    return Dtls13GetRlHeaderLength(ssl, 1) + DTLS13_MIN_CIPHERTEXT;
+    return headerLength + DTLS13_MIN_CIPHERTEXT;
 }
 
 /**
@@ -1303,12 +1345,8 @@ int Dtls13EncryptRecordNumber(WOLFSSL* ssl, byte* hdr, word16 recordLength)
         return 0;
 #endif /*HAVE_NULL_CIPHER */
 
-    /* we need at least a 16 bytes of ciphertext to encrypt record number see
-       4.2.3*/
-    if (recordLength < Dtls13MinimumRecordLength(ssl))
-        return BUFFER_ERROR;
-
-    seqLength = (*hdr & DTLS13_LEN_BIT) ? DTLS13_SEQ_16_LEN : DTLS13_SEQ_8_LEN;
+    seqLength = (*hdr & DTLS13_SEQ_LEN_BIT) ?
+        DTLS13_SEQ_16_LEN : DTLS13_SEQ_8_LEN;
 
     cidSz = DtlsGetCidTxSize(ssl);
     /* header flags + seq number + CID size*/
@@ -1318,6 +1356,11 @@ int Dtls13EncryptRecordNumber(WOLFSSL* ssl, byte* hdr, word16 recordLength)
     if (*hdr & DTLS13_LEN_BIT)
         hdrLength += DTLS13_LEN_SIZE;
 
+    /* we need at least a 16 bytes of ciphertext to encrypt record number see
+       4.2.3*/
+    if (recordLength < Dtls13MinimumRecordLength((word16)hdrLength))
+        return BUFFER_ERROR;
+
     return Dtls13EncryptDecryptRecordNumber(ssl,
         /* seq number offset */
         hdr + OPAQUE8_LEN + cidSz,
@@ -1373,6 +1416,66 @@ int Dtls13IsUnifiedHeader(byte hdrFirstByte)
     return ((hdrFirstByte & DTLS13_FIXED_BITS_MASK) == DTLS13_FIXED_BITS);
 }
 
+/**
+ * Dtls13DatagramLength() - length of the next datagram to send
+ * @ssl: ssl object
+ * @buf: records pending in the output buffer
+ * @length: number of bytes pending
+ *
+ * With message grouping a whole flight is appended to the output buffer
+ * before it is sent. Cut it at the last record boundary that still fits the
+ * MTU so the flight leaves in as few datagrams as possible and no record
+ * straddles two of them. A record that is larger than the MTU on its own, or
+ * that carries no length field, is sent as is.
+ */
+word32 Dtls13DatagramLength(WOLFSSL* ssl, const byte* buf, word32 length)
+{
+    word32 recordLength;
+    word32 idx = 0;
+    word16 hdrLength;
+    word16 fragLength;
+    word32 mtu;
+
+#if defined(WOLFSSL_SCTP) || defined(WOLFSSL_DTLS_MTU)
+    mtu = (word32)ssl->dtlsMtuSz;
+#else
+    mtu = MAX_MTU;
+#endif
+
+    while (idx < length) {
+        if (Dtls13IsUnifiedHeader(buf[idx])) {
+            hdrLength = OPAQUE8_LEN;
+            if (buf[idx] & DTLS13_CID_BIT)
+                hdrLength += DtlsGetCidTxSize(ssl);
+            hdrLength += (buf[idx] & DTLS13_SEQ_LEN_BIT) ? DTLS13_SEQ_16_LEN
+                                                         : DTLS13_SEQ_8_LEN;
+            if (!(buf[idx] & DTLS13_LEN_BIT)) {
+                /* runs to the end of the datagram */
+                recordLength = length - idx;
+            }
+            else {
+                if (idx + hdrLength + DTLS13_LEN_SIZE > length)
+                    return length;
+                ato16(buf + idx + hdrLength, &fragLength);
+                recordLength = hdrLength + DTLS13_LEN_SIZE + fragLength;
+            }
+        }
+        else {
+            if (idx + DTLS_RECORD_HEADER_SZ > length)
+                return length;
+            ato16(buf + idx + DTLS_RECORD_HEADER_SZ - OPAQUE16_LEN,
+                &fragLength);
+            recordLength = DTLS_RECORD_HEADER_SZ + fragLength;
+        }
+
+        if (idx > 0 && idx + recordLength > mtu)
+            break;
+        idx += recordLength;
+    }
+
+    return idx < length ? idx : length;
+}
+
 int Dtls13ReconstructSeqNumber(WOLFSSL* ssl, Dtls13UnifiedHdrInfo* hdrInfo,
     w64wrapper* out)
 {
@@ -1663,6 +1766,11 @@ static int Dtls13RtxSendBuffered(WOLFSSL* ssl)
         r->seq[r->rnIdx] = seq;
         r->rnIdx++;
 
+#ifdef WOLFSSL_DTLS13_RTX_STATS
+        ssl->dtls13Rtx.rtxRecordCount++;
+        ssl->dtls13Rtx.rtxByteCount += r->length;
+#endif
+
         if (ret == WC_NO_ERR_TRACE(WANT_WRITE)) {
             /* this fragment will be sent eventually. Move it to the end of the
                list so next time we start with a new one. */
@@ -1734,6 +1842,7 @@ int Dtls13CheckEpoch(WOLFSSL* ssl, enum HandShakeType type)
                 break;
             case certificate_request:
             case certificate:
+            case compressed_certificate:
             case certificate_verify:
             case finished:
                 if (!ssl->options.handShakeDone) {
@@ -1851,6 +1960,14 @@ static int _Dtls13HandshakeRecv(WOLFSSL* ssl, byte* input, word32 size,
     if (fragOff + fragLength > messageLength)
         return BUFFER_ERROR;
 
+    /* Reassembly allocates the whole message up front, so cap it like a
+     * TLS handshake message. */
+    if (messageLength > MAX_HANDSHAKE_SZ) {
+        WOLFSSL_MSG("Handshake message too large");
+        WOLFSSL_ERROR_VERBOSE(HANDSHAKE_SIZE_ERROR);
+        return HANDSHAKE_SIZE_ERROR;
+    }
+
     ret = Dtls13RtxMsgRecvd(ssl, (enum HandShakeType)handshakeType, fragOff);
     if (ret != 0)
         return ret;
@@ -2043,7 +2160,9 @@ int Dtls13HandshakeSend(WOLFSSL* ssl, byte* message, word16 outputSize,
            arrived out-of-order (before the server finished) so likely an ACK
            was already sent. In the worst case we will ACK the server
            retranmission*/
-        if (handshakeType == certificate || handshakeType == finished ||
+        if (handshakeType == certificate ||
+            handshakeType == compressed_certificate ||
+            handshakeType == finished ||
             handshakeType == server_hello || handshakeType == client_hello)
             Dtls13RtxFlushAcks(ssl);
     }
@@ -2064,7 +2183,7 @@ int Dtls13HandshakeSend(WOLFSSL* ssl, byte* message, word16 outputSize,
     if (maxLen < maxFrag) {
         printf("qwerty\n");
         ret = Dtls13SendOneFragmentRtx(ssl, handshakeType, outputSize, message,
-            length, hashOutput);
+            length, hashOutput, Dtls13SendNow(ssl, handshakeType));
         if (ret == 0 || ret == WC_NO_ERR_TRACE(WANT_WRITE))
             ssl->keys.dtls_handshake_number++;
     }
@@ -2681,7 +2800,8 @@ static void Dtls13PrintRtxRecord(Dtls13RtxRecord* r)
 }
 #endif /* WOLFSSL_DEBUG_TLS */
 
-static void Dtls13RtxRemoveRecord(WOLFSSL* ssl, w64wrapper epoch,
+/* returns 1 when a buffered record was acknowledged by (epoch, seq) */
+static int Dtls13RtxRemoveRecord(WOLFSSL* ssl, w64wrapper epoch,
     w64wrapper seq)
 {
     Dtls13RtxRecord *r, **prevNext;
@@ -2700,13 +2820,13 @@ static void Dtls13RtxRemoveRecord(WOLFSSL* ssl, w64wrapper epoch,
 #endif /* WOLFSSL_DEBUG_TLS */
             Dtls13RtxRecordUnlink(ssl, prevNext, r);
             Dtls13FreeRtxBufferRecord(ssl, r);
-            return;
+            return 1;
         }
         prevNext = &r->next;
         r = r->next;
     }
 
-    return;
+    return 0;
 }
 
 int Dtls13DoScheduledWork(WOLFSSL* ssl)
@@ -2730,17 +2850,25 @@ int Dtls13DoScheduledWork(WOLFSSL* ssl)
 #ifdef WOLFSSL_RW_THREADED
     ret = wc_UnLockMutex(&ssl->dtls13Rtx.mutex);
 #endif
-    if (sendAcks) {
-        ret = SendDtls13Ack(ssl);
-        if (ret != 0)
-            return ret;
+    if (ssl->dtls13AckDelay != 0 && (sendAcks || ssl->dtls13Rtx.retransmit)) {
+        /* Hold the ACK and any retransmission until the quick timeout. The
+         * records that arrive meanwhile go in the same ACK, and a burst of
+         * peer retransmissions is answered once. */
+        ssl->dtls13FastTimeout = 1;
     }
+    else {
+        if (sendAcks) {
+            ret = SendDtls13Ack(ssl);
+            if (ret != 0)
+                return ret;
+        }
 
-    if (ssl->dtls13Rtx.retransmit) {
-        ssl->dtls13Rtx.retransmit = 0;
-        ret = Dtls13RtxSendBuffered(ssl);
-        if (ret != 0)
-            return ret;
+        if (ssl->dtls13Rtx.retransmit) {
+            ssl->dtls13Rtx.retransmit = 0;
+            ret = Dtls13RtxSendBuffered(ssl);
+            if (ret != 0)
+                return ret;
+        }
     }
 
     ssl->dtls13SendingAckOrRtx = 0;
@@ -2759,8 +2887,16 @@ int Dtls13DoScheduledWork(WOLFSSL* ssl)
  * flight after a long timeout */
 int Dtls13RtxTimeout(WOLFSSL* ssl)
 {
+    byte fastTimeout = ssl->dtls13FastTimeout;
+    /* a retransmission held back by the ACK delay */
+    byte heldRtx = fastTimeout && ssl->dtls13Rtx.retransmit;
     int ret = 0;
 
+    /* the write delay is over */
+    ret = Dtls13FlushWrites(ssl);
+    if (ret != 0)
+        return ret;
+
     /* We don't want to send acks until we have done version
      * negotiation in the SH or have received a unified header in the
      * DTLS record. */
@@ -2775,12 +2911,23 @@ int Dtls13RtxTimeout(WOLFSSL* ssl)
             return ret;
     }
 
+    /* It answers a peer retransmission, so it goes out without backing off
+     * the timer. */
+    if (heldRtx) {
+        ssl->dtls13FastTimeout = 0;
+        ssl->dtls13Rtx.retransmit = 0;
+        return Dtls13RtxSendBuffered(ssl);
+    }
+
     /* we have two timeouts, a shorter (dtls13FastTimeout = 1) and a longer
        one. When the shorter expires we only send ACKs, as it normally means
        that some messages we are waiting for don't arrive yet. But we
        retransmit our buffered messages only if the longer timeout
-       expires. fastTimeout is 1/4 of the longer timeout */
-    if (ssl->dtls13FastTimeout) {
+       expires. fastTimeout is 1/4 of the longer timeout, or the ACK delay
+       when one is set. Sending the ACKs above does not turn the shorter
+       timeout into a longer one: the peer is still delivering its flight,
+       and the ACK lets it resend just the records we are missing. */
+    if (fastTimeout) {
         ssl->dtls13FastTimeout = 0;
         return 0;
     }
@@ -2789,9 +2936,107 @@ int Dtls13RtxTimeout(WOLFSSL* ssl)
     if (DtlsMsgPoolTimeout(ssl) != 0)
         return WOLFSSL_FATAL_ERROR;
 
+#ifdef WOLFSSL_DTLS13_RTX_STATS
+    if (ssl->dtls13Rtx.rtxRecords != NULL)
+        ssl->dtls13Rtx.timeoutCount++;
+#endif
+
+    ssl->dtls13Rtx.retransmit = 0;
     return Dtls13RtxSendBuffered(ssl);
 }
 
+/**
+ * Dtls13HoldWrite() - hold a small application write back
+ * @ssl: ssl object
+ * @data: application data
+ * @sz: length of @data
+ *
+ * With a write delay set, writes that fit in one record are collected and go
+ * out as one record when the delay is over (Dtls13RtxTimeout()), when the next
+ * write does not fit, or before the close_notify. While something is held the
+ * quick timeout is on.
+ *
+ * returns 1 when @data is held, 0 when the caller has to send it (anything
+ * held went out first) or a negative error.
+ */
+int Dtls13HoldWrite(WOLFSSL* ssl, const byte* data, word32 sz)
+{
+    int maxFrag;
+    int ret;
+
+    if (ssl->dtls13WriteDelay == 0 || !ssl->options.handShakeDone || sz == 0)
+        return Dtls13FlushWrites(ssl);
+
+    maxFrag = wolfSSL_GetMaxFragSize(ssl, MAX_RECORD_SIZE);
+    if (ssl->dtls13HeldWrites.buffer != NULL &&
+            maxFrag > ssl->dtls13HeldWritesSz)
+        maxFrag = ssl->dtls13HeldWritesSz;
+
+    if (ssl->dtls13HeldWrites.length + sz > (word32)maxFrag) {
+        ret = Dtls13FlushWrites(ssl);
+        if (ret != 0)
+            return ret;
+    }
+
+    /* fills a record on its own */
+    if (sz >= (word32)maxFrag)
+        return 0;
+
+    if (ssl->dtls13HeldWrites.buffer == NULL) {
+        ssl->dtls13HeldWrites.buffer = (byte*)XMALLOC((size_t)maxFrag,
+            ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        if (ssl->dtls13HeldWrites.buffer == NULL)
+            return MEMORY_E;
+        ssl->dtls13HeldWritesSz = (word16)maxFrag;
+    }
+
+    XMEMCPY(ssl->dtls13HeldWrites.buffer + ssl->dtls13HeldWrites.length, data,
+        sz);
+    ssl->dtls13HeldWrites.length += sz;
+    ssl->dtls13FastTimeout = 1;
+
+    return 1;
+}
+
+/**
+ * Dtls13FlushWrites() - send the writes held by Dtls13HoldWrite()
+ * @ssl: ssl object
+ *
+ * They go out as one application data record. If the socket blocks once the
+ * record is built it stays in the output buffer and goes out with the next
+ * send; if it blocks before, the writes stay held.
+ */
+int Dtls13FlushWrites(WOLFSSL* ssl)
+{
+    word32 length = ssl->dtls13HeldWrites.length;
+    int ret;
+
+    if (length == 0)
+        return 0;
+
+    if (ssl->buffers.outputBuffer.length > 0) {
+        ret = SendBuffered(ssl);
+        if (ret != 0)
+            return ret;
+    }
+
+    /* set by SendData() when the record is built but could not be sent */
+    ssl->buffers.plainSz = 0;
+    ssl->dtls13HeldWrites.length = 0;
+    ret = SendData(ssl, ssl->dtls13HeldWrites.buffer, length);
+    if (ret == WC_NO_ERR_TRACE(WANT_WRITE)) {
+        if (ssl->buffers.plainSz == 0) {
+            ssl->dtls13HeldWrites.length = length;
+            return ret;
+        }
+        ssl->buffers.plainSz = 0;
+        ssl->buffers.prevSent = 0;
+        return 0;
+    }
+
+    return ret < 0 ? ret : 0;
+}
+
 static int Dtls13RtxHasKeyUpdateBuffered(WOLFSSL* ssl)
 {
     Dtls13RtxRecord* r = ssl->dtls13Rtx.rtxRecords;
@@ -2825,6 +3070,7 @@ int DoDtls13Ack(WOLFSSL* ssl, const byte* input, word32 inputSize,
     const byte* ackMessage;
     w64wrapper epoch, seq;
     word16 length;
+    int acked = 0;
 #ifndef WOLFSSL_RW_THREADED
     int ret;
 #endif
@@ -2848,7 +3094,16 @@ int DoDtls13Ack(WOLFSSL* ssl, const byte* input, word32 inputSize,
         ato64(ackMessage + i, &epoch);
         ato64(ackMessage + i + OPAQUE64_LEN, &seq);
         WOLFSSL_MSG_EX("epoch %d seq %d", epoch, seq);
-        Dtls13RtxRemoveRecord(ssl, epoch, seq);
+        acked += Dtls13RtxRemoveRecord(ssl, epoch, seq);
+    }
+
+    if (acked > 0) {
+        /* The peer is receiving: whatever is left is what it lacks, and the
+         * timer that backed off while nothing got through starts over. */
+        ssl->dtls_timeout = ssl->dtls_timeout_init;
+#ifdef WOLFSSL_DTLS13_RTX_STATS
+        ssl->dtls13Rtx.ackedCount += (word32)acked;
+#endif
     }
 
     /* last client flight was completely acknowledged by the server. Handshake
@@ -2882,6 +2882,12 @@ void SSL_CtxResourceFree(WOLFSSL_CTX* ctx)
         }
     #endif /* KEEP_OUR_CERT */
     FreeDer(&ctx->certChain);
+    #ifdef HAVE_RPK
+        XFREE(ctx->rpkPins, ctx->heap, DYNAMIC_TYPE_CERT);
+        ctx->rpkPins = NULL;
+        ctx->rpkPinsCnt = 0;
+        ctx->rpkPinsMax = 0;
+    #endif
     wolfSSL_CertManagerFree(ctx->cm);
     ctx->cm = NULL;
     #ifdef OPENSSL_ALL
@@ -9277,28 +9283,35 @@ void WriteSEQ(WOLFSSL* ssl, int verifyOrder, byte* out)
  * routines assume the message pointer is still within the buffer that
  * has the headers, and will include those headers in the hash. The store
  * routines need to take that into account as well. New will allocate
- * extra space for the headers. */
+ * extra space for the headers.
+ *
+ * The whole message lives in the same allocation as the DtlsMsg. A received
+ * message also carries room for DTLS_FRAG_POOL_SZ received ranges, so
+ * fragments are copied straight to their offset as they arrive, in any order,
+ * without further allocations. */
 DtlsMsg* DtlsMsgNew(word32 sz, byte tx, void* heap)
 {
     DtlsMsg* msg;
+    word32 rangesSz = tx ? 0 : DTLS_FRAG_POOL_SZ * sizeof(word32[2]);
     WOLFSSL_ENTER("DtlsMsgNew");
 
     (void)heap;
-    msg = (DtlsMsg*)XMALLOC(sizeof(DtlsMsg), heap, DYNAMIC_TYPE_DTLS_MSG);
+    msg = (DtlsMsg*)XMALLOC(sizeof(DtlsMsg) + rangesSz +
+                            DTLS_HANDSHAKE_HEADER_SZ + sz, heap,
+                            DYNAMIC_TYPE_DTLS_MSG);
 
     if (msg != NULL) {
         XMEMSET(msg, 0, sizeof(DtlsMsg));
         msg->sz = sz;
         msg->type = no_shake;
+        msg->raw = (byte*)(msg + 1) + rangesSz;
         if (tx) {
-            msg->raw = msg->fullMsg =
-                    (byte*)XMALLOC(sz + DTLS_HANDSHAKE_HEADER_SZ, heap,
-                            DYNAMIC_TYPE_DTLS_FRAG);
+            msg->fullMsg = msg->raw;
             msg->ready = 1;
-            if (msg->raw == NULL) {
-                DtlsMsgDelete(msg, heap);
-                msg = NULL;
-            }
+        }
+        else {
+            msg->rxRanges = (word32(*)[2])(void*)(msg + 1);
+            msg->fullMsg = msg->raw + DTLS_HANDSHAKE_HEADER_SZ;
         }
     }
 
@@ -9310,15 +9323,7 @@ void DtlsMsgDelete(DtlsMsg* item, void* heap)
     (void)heap;
     WOLFSSL_ENTER("DtlsMsgDelete");
 
-    if (item != NULL) {
-        while (item->fragBucketList != NULL) {
-            DtlsFragBucket* next = item->fragBucketList->m.m.next;
-            DtlsMsgDestroyFragBucket(item->fragBucketList, heap);
-            item->fragBucketList = next;
-        }
-        XFREE(item->raw, heap, DYNAMIC_TYPE_DTLS_FRAG);
-        XFREE(item, heap, DYNAMIC_TYPE_DTLS_MSG);
-    }
+    XFREE(item, heap, DYNAMIC_TYPE_DTLS_MSG);
 }
 
 
@@ -9355,190 +9360,55 @@ void DtlsTxMsgListClean(WOLFSSL* ssl)
     ssl->dtls_tx_msg_list = head;
 }
 
-static DtlsFragBucket* DtlsMsgCreateFragBucket(word32 offset, const byte* data,
-                                               word32 dataSz, void* heap)
+/* Record bytes [start, end) of the message as received, merging with the
+ * ranges it overlaps or touches, and keep bytesReceived in step. */
+static int DtlsMsgAddRange(DtlsMsg* msg, word32 start, word32 end)
 {
-    DtlsFragBucket* bucket =
-            (DtlsFragBucket*)XMALLOC(sizeof(DtlsFragBucket) + dataSz, heap,
-                                     DYNAMIC_TYPE_DTLS_FRAG);
-    if (bucket != NULL) {
-        XMEMSET(bucket, 0, sizeof(*bucket));
-        bucket->m.m.next = NULL;
-        bucket->m.m.offset = offset;
-        bucket->m.m.sz = dataSz;
-        if (data != NULL)
-            XMEMCPY(bucket->buf, data, dataSz);
-    }
-    (void)heap;
-    return bucket;
-}
-
-void DtlsMsgDestroyFragBucket(DtlsFragBucket* fragBucket, void* heap)
-{
-    (void)heap;
-    XFREE(fragBucket, heap, DYNAMIC_TYPE_DTLS_FRAG);
-}
-
-/*
- * data overlaps with cur but is before next.
- * data + dataSz has to end before or inside next. next can be NULL.
- */
-static DtlsFragBucket* DtlsMsgCombineFragBuckets(DtlsMsg* msg,
-        DtlsFragBucket* cur, DtlsFragBucket* next, word32 offset,
-        const byte* data, word32 dataSz, void* heap)
-{
-    word32 offsetEnd = offset + dataSz;
-    word32 newOffset = min(cur->m.m.offset, offset);
-    word32 newOffsetEnd;
-    word32 newSz;
-    word32 overlapSz = cur->m.m.sz;
-    DtlsFragBucket** chosenBucket;
-    DtlsFragBucket* newBucket;
-    DtlsFragBucket* otherBucket;
-    byte combineNext = FALSE;
-
-    if (next != NULL && offsetEnd >= next->m.m.offset)
-        combineNext = TRUE;
-
-    if (combineNext)
-        newOffsetEnd = next->m.m.offset + next->m.m.sz;
-    else
-        newOffsetEnd = max(cur->m.m.offset + cur->m.m.sz, offsetEnd);
-
-    newSz = newOffsetEnd - newOffset;
-
-    /* Expand the larger bucket if data bridges the gap between cur and next */
-    if (!combineNext || cur->m.m.sz >= next->m.m.sz) {
-        chosenBucket = &cur;
-        otherBucket = next;
-    }
-    else {
-        chosenBucket = &next;
-        otherBucket = cur;
-    }
-
-    {
-#ifdef XREALLOC
-        DtlsFragBucket* tmp = (DtlsFragBucket*)XREALLOC(*chosenBucket,
-                sizeof(DtlsFragBucket) + newSz, heap, DYNAMIC_TYPE_DTLS_FRAG);
-#else
-        DtlsFragBucket* tmp = (DtlsFragBucket*)XMALLOC(
-                sizeof(DtlsFragBucket) + newSz, heap, DYNAMIC_TYPE_DTLS_FRAG);
-#endif
-        if (tmp == NULL)
-            return NULL;
-#ifndef XREALLOC
-        XMEMCPY(tmp, *chosenBucket, sizeof(DtlsFragBucket) +
-                (*chosenBucket)->m.m.sz);
-#endif
-        if (chosenBucket == &next) {
-            /* Update the link */
-            DtlsFragBucket* beforeNext = cur;
-            while (beforeNext->m.m.next != next)
-                beforeNext = beforeNext->m.m.next;
-            beforeNext->m.m.next = tmp;
-        }
-#ifndef XREALLOC
-        XFREE(*chosenBucket, heap, DYNAMIC_TYPE_DTLS_FRAG);
-#endif
-        newBucket = *chosenBucket = tmp;
-    }
+    word32 (*r)[2] = msg->rxRanges;
+    byte n = msg->rxRangeCnt;
+    byte i = 0;
+    byte j;
 
-    if (combineNext) {
-        /* Put next first since it will always be at the end. Use memmove since
-         * newBucket may be next. */
-        XMEMMOVE(newBucket->buf + (next->m.m.offset - newOffset), next->buf,
-                next->m.m.sz);
-        /* memory after newOffsetEnd is already copied. Don't do extra work. */
-        newOffsetEnd = next->m.m.offset;
+    while (i < n && r[i][1] < start)
+        i++;
+    for (j = i; j < n && r[j][0] <= end; j++) {
+        start = min(start, r[j][0]);
+        end = max(end, r[j][1]);
+        msg->bytesReceived -= r[j][1] - r[j][0];
     }
 
-    if (newOffset == offset) {
-        /* data comes first */
-        if (newOffsetEnd <= offsetEnd) {
-            /* data encompasses cur. only copy data */
-            XMEMCPY(newBucket->buf, data,
-                    min(dataSz, newOffsetEnd - newOffset));
-        }
-        else {
-            /* data -> cur. memcpy as much possible as its faster. */
-            XMEMMOVE(newBucket->buf + dataSz, cur->buf,
-                    cur->m.m.sz - (offsetEnd - cur->m.m.offset));
-            XMEMCPY(newBucket->buf, data, dataSz);
+    if (j == i) {
+        /* disjoint from anything we have received so far */
+        if (n >= DTLS_FRAG_POOL_SZ) {
+            WOLFSSL_ERROR_VERBOSE(DTLS_TOO_MANY_FRAGMENTS_E);
+            return DTLS_TOO_MANY_FRAGMENTS_E;
         }
+        XMEMMOVE(r[i + 1], r[i], (n - i) * sizeof(r[0]));
+        n++;
     }
-    else {
-        /* cur -> data */
-        word32 curOffsetEnd = cur->m.m.offset + cur->m.m.sz;
-        if (newBucket != cur)
-            XMEMCPY(newBucket->buf, cur->buf, cur->m.m.sz);
-        XMEMCPY(newBucket->buf + cur->m.m.sz,
-                data + (curOffsetEnd - offset),
-                newOffsetEnd - curOffsetEnd);
+    else if (j - i > 1) {
+        /* ranges i..j-1 collapse into r[i] */
+        XMEMMOVE(r[i + 1], r[j], (n - j) * sizeof(r[0]));
+        n = (byte)(n - (j - i - 1));
     }
-    /* FINALLY the newBucket is populated correctly */
+    r[i][0] = start;
+    r[i][1] = end;
+    msg->bytesReceived += end - start;
+    msg->rxRangeCnt = n;
 
-    /* All buckets up to and including next (if combining) have to be free'd */
-    {
-        DtlsFragBucket* toFree = cur->m.m.next;
-        while (toFree != next) {
-            DtlsFragBucket* n = toFree->m.m.next;
-            overlapSz += toFree->m.m.sz;
-            DtlsMsgDestroyFragBucket(toFree, heap);
-            msg->fragBucketListCount--;
-            toFree = n;
-        }
-        if (combineNext) {
-            newBucket->m.m.next = next->m.m.next;
-            overlapSz += next->m.m.sz;
-            DtlsMsgDestroyFragBucket(otherBucket, heap);
-            msg->fragBucketListCount--;
-        }
-        else {
-            newBucket->m.m.next = next;
-        }
-    }
-    /* Adjust size in msg */
-    msg->bytesReceived += newSz - overlapSz;
-    newBucket->m.m.offset = newOffset;
-    newBucket->m.m.sz = newSz;
-    return newBucket;
+    return 0;
 }
 
 static void DtlsMsgAssembleCompleteMessage(DtlsMsg* msg)
 {
     DtlsHandShakeHeader* dtls;
 
-    /* We have received all necessary fragments. Reconstruct the header. */
-    if (msg->fragBucketListCount != 1 || msg->fragBucketList->m.m.offset != 0 ||
-            msg->fragBucketList->m.m.sz != msg->sz) {
-        WOLFSSL_MSG("Major error in fragment assembly logic");
-        return;
-    }
+    /* We have received all necessary fragments. Reconstruct the header in the
+     * space left for it in front of the message. */
+    dtls = (DtlsHandShakeHeader*)(void*)msg->raw;
 
-    /* Re-cycle the DtlsFragBucket as the buffer that holds the complete
-     * handshake message and the header. */
-    msg->raw = (byte*)msg->fragBucketList;
-    msg->fullMsg = msg->fragBucketList->buf;
     msg->ready = 1;
-
-    /* frag->padding makes sure we can fit the entire DTLS handshake header
-     * before frag->buf */
-
-    /* note the dtls pointer needs to be computed from msg->fragBucketList, not
-     * from msg->fragBucketList->buf, to avoid a pointerOutOfBounds access
-     * detected by cppcheck.
-     *
-     * also note, the (void *) intermediate cast is necessary to avoid a
-     * potential -Wcast-align around alignment of DtlsHandShakeHeader exceeding
-     * alignment of char.
-     */
-    dtls = (DtlsHandShakeHeader*)(void *)((char *)msg->fragBucketList
-                                          + WC_OFFSETOF(DtlsFragBucket,buf)
-                                          - DTLS_HANDSHAKE_HEADER_SZ);
-
-    msg->fragBucketList = NULL;
-    msg->fragBucketListCount = 0;
+    msg->rxRangeCnt = 0;
 
     dtls->type = msg->type;
     c32to24(msg->sz, dtls->length);
@@ -9579,85 +9449,15 @@ int DtlsMsgSet(DtlsMsg* msg, word32 seq, word16 epoch, const byte* data, byte ty
         msg->encrypted = encrypted;
     }
 
-    if (msg->fragBucketList == NULL) {
-        /* Clean list. Create first fragment. */
-        msg->fragBucketList = DtlsMsgCreateFragBucket(fragOffset, data, fragSz, heap);
-        if (msg->fragBucketList != NULL) {
-            msg->bytesReceived = fragSz;
-            msg->fragBucketListCount++;
-        }
-        else {
-            return MEMORY_ERROR;
-        }
-    }
-    else {
-        /* See if we can expand any existing bucket to fit this new data into */
-        DtlsFragBucket* prev = NULL;
-        DtlsFragBucket* cur = msg->fragBucketList;
-        byte done = 0;
-        for (; cur != NULL; prev = cur, cur = cur->m.m.next) {
-            word32 curOffset = cur->m.m.offset;
-            word32 curEnd    = cur->m.m.offset + cur->m.m.sz;
-
-            if (fragOffset >= curOffset && fragOffsetEnd <= curEnd) {
-                /* We already have this fragment */
-                done = 1;
-                break;
-            }
-            else if (fragOffset <= curEnd) {
-                /* found place to store fragment */
-                break;
-            }
-        }
-        if (!done) {
-            if (cur == NULL) {
-                /* We reached the end of the list. data is after and disjointed
-                 * from anything we have received so far. */
-                if (msg->fragBucketListCount >= DTLS_FRAG_POOL_SZ) {
-                    WOLFSSL_ERROR_VERBOSE(DTLS_TOO_MANY_FRAGMENTS_E);
-                    return DTLS_TOO_MANY_FRAGMENTS_E;
-                }
-                prev->m.m.next =
-                        DtlsMsgCreateFragBucket(fragOffset, data, fragSz, heap);
-                if (prev->m.m.next != NULL) {
-                    msg->bytesReceived += fragSz;
-                    msg->fragBucketListCount++;
-                }
-            }
-            else if (prev == NULL && fragOffsetEnd < cur->m.m.offset) {
-                    /* This is the new first fragment we have received */
-                    if (msg->fragBucketListCount >= DTLS_FRAG_POOL_SZ) {
-                        WOLFSSL_ERROR_VERBOSE(DTLS_TOO_MANY_FRAGMENTS_E);
-                        return DTLS_TOO_MANY_FRAGMENTS_E;
-                    }
-                    msg->fragBucketList = DtlsMsgCreateFragBucket(fragOffset, data,
-                            fragSz, heap);
-                    if (msg->fragBucketList != NULL) {
-                        msg->fragBucketList->m.m.next = cur;
-                        msg->bytesReceived += fragSz;
-                        msg->fragBucketListCount++;
-                    }
-                    else {
-                        /* reset on error */
-                        msg->fragBucketList = cur;
-                    }
-            }
-            else {
-                /* Find if this fragment overlaps with any more */
-                DtlsFragBucket* next = cur->m.m.next;
-                DtlsFragBucket** prev_next = prev != NULL
-                        ? &prev->m.m.next : &msg->fragBucketList;
-                while (next != NULL &&
-                        (next->m.m.offset + next->m.m.sz) <= fragOffsetEnd)
-                    next = next->m.m.next;
-                /* We can combine the buckets */
-                *prev_next = DtlsMsgCombineFragBuckets(msg, cur, next,
-                        fragOffset, data, fragSz, heap);
-                if (*prev_next == NULL) /* reset on error */
-                    *prev_next = cur;
-            }
-        }
+    if (fragSz > 0) {
+        int ret = DtlsMsgAddRange(msg, fragOffset, fragOffsetEnd);
+        if (ret != 0)
+            return ret;
+        /* A retransmitted fragment overwrites bytes already held with the
+         * same data. */
+        XMEMCPY(msg->fullMsg + fragOffset, data, fragSz);
     }
+    (void)heap;
 
     if (msg->bytesReceived == msg->sz)
         DtlsMsgAssembleCompleteMessage(msg);
@@ -11061,11 +10861,20 @@ int SendBuffered(WOLFSSL* ssl)
 
     while (ssl->buffers.outputBuffer.length > 0) {
         int sent = 0;
+        word32 sendSz = ssl->buffers.outputBuffer.length;
+#ifdef WOLFSSL_DTLS13
+        /* a grouped flight leaves as MTU sized datagrams of whole records */
+        if (ssl->options.dtls && IsAtLeastTLSv1_3(ssl->version) &&
+                IsDtlsNotSctpMode(ssl))
+            sendSz = Dtls13DatagramLength(ssl,
+                ssl->buffers.outputBuffer.buffer +
+                ssl->buffers.outputBuffer.idx, sendSz);
+#endif
 retry:
         sent = ssl->CBIOSend(ssl,
                              (char*)ssl->buffers.outputBuffer.buffer +
                              ssl->buffers.outputBuffer.idx,
-                             (int)ssl->buffers.outputBuffer.length,
+                             (int)sendSz,
                              ssl->IOCB_WriteCtx);
         if (sent < 0) {
             switch (sent) {
@@ -11377,7 +11186,19 @@ int CheckAvailableSize(WOLFSSL *ssl, int size)
 #else
         word32 mtu = MAX_MTU;
 #endif
-        if ((word32)size + ssl->buffers.outputBuffer.length > mtu) {
+        int flush = (word32)size + ssl->buffers.outputBuffer.length > mtu;
+#ifdef WOLFSSL_DTLS13
+        if (IsAtLeastTLSv1_3(ssl->version) && IsDtlsNotSctpMode(ssl)) {
+            /* SendBuffered() cuts a DTLS1.3 flight into datagrams itself, so
+               keep appending and let the whole flight be packed at once. An
+               application data record with the short header may go without
+               a length though, and then nothing can follow it. */
+            flush = ssl->buffers.outputBuffer.length > 0 &&
+                    ssl->options.dtls13ShortHeader &&
+                    ssl->options.handShakeDone;
+        }
+#endif /* WOLFSSL_DTLS13 */
+        if (flush) {
             int ret;
             WOLFSSL_MSG("CheckAvailableSize() flushing buffer "
                         "to make room for new message");
@@ -11440,6 +11261,7 @@ int MsgCheckEncryption(WOLFSSL* ssl, byte type, byte encrypted)
             case end_of_early_data:
             case encrypted_extensions:
             case certificate:
+            case compressed_certificate:
             case server_key_exchange:
             case certificate_request:
             case server_hello_done:
@@ -11552,6 +11374,7 @@ static int MsgCheckBoundary(const WOLFSSL* ssl, byte type,
                 case session_ticket:
                 case encrypted_extensions:
                 case certificate:
+                case compressed_certificate:
                 case server_key_exchange:
                 case certificate_request:
                 case certificate_verify:
@@ -11622,6 +11445,7 @@ static int MsgCheckBoundary(const WOLFSSL* ssl, byte type,
             case hello_retry_request:
             case encrypted_extensions:
             case certificate:
+            case compressed_certificate:
             case server_key_exchange:
             case certificate_request:
             case server_hello_done:
@@ -15001,6 +14825,17 @@ PRAGMA_GCC_DIAG_POP
             }
         }
     }
+    /* a raw public key carries no signature to verify, so with an
+     * allow-list configured it is authenticated by being on it */
+    if (ret == 0 && args->dCert->isRPK && ssl->ctx->rpkPinsCnt > 0) {
+        byte spkiHash[WC_SHA256_DIGEST_SIZE];
+
+        ret = wc_Sha256Hash(cert->buffer, cert->length, spkiHash);
+        if (ret == 0 && !RpkPinFind(ssl->ctx, spkiHash, NULL)) {
+            WOLFSSL_MSG("raw public key not on the allow-list");
+            ret = VERIFY_CERT_ERROR;
+        }
+    }
 #endif /* HAVE_RPK */
 
     /* perform below checks for date failure cases */
@@ -15512,12 +15347,39 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
                     ERROR_OUT(BUFFER_ERROR, exit_ppc);
                 }
 
-                args->certs[args->totalCerts].length = certSz;
-                args->certs[args->totalCerts].buffer = input + args->idx;
+            #if defined(HAVE_CACHED_INFO) && !defined(NO_WOLFSSL_CLIENT)
+                if (ssl->options.side == WOLFSSL_CLIENT_END &&
+                        ssl->options.cachedInfoCert) {
+                    /* The only entry is the hash of the certificate we hold
+                     * (RFC 7924). Verify our copy where it is rather than
+                     * rebuilding the message around it. */
+                    if (args->totalCerts != 0 ||
+                            certSz != WC_SHA256_DIGEST_SIZE) {
+                        ERROR_OUT(BUFFER_ERROR, exit_ppc);
+                    }
+                    if (ConstantCompare(input + args->idx,
+                            ssl->ctx->cachedCertHash,
+                            WC_SHA256_DIGEST_SIZE) != 0) {
+                        WOLFSSL_MSG("Server certificate hash is not the "
+                                    "cached certificate");
+                        SendAlert(ssl, alert_fatal, bad_certificate);
+                        WOLFSSL_ERROR_VERBOSE(VERIFY_CERT_ERROR);
+                        ERROR_OUT(VERIFY_CERT_ERROR, exit_ppc);
+                    }
+                    args->certs[0].length = ssl->ctx->cachedCertSz;
+                    args->certs[0].buffer = (byte*)ssl->ctx->cachedCert;
+                }
+                else
+            #endif
+                {
+                    args->certs[args->totalCerts].length = certSz;
+                    args->certs[args->totalCerts].buffer = input + args->idx;
+                }
 
             #ifdef SESSION_CERTS
                 AddSessionCertToChain(&ssl->session->chain,
-                    input + args->idx, certSz);
+                    args->certs[args->totalCerts].buffer,
+                    args->certs[args->totalCerts].length);
             #endif /* SESSION_CERTS */
 
                 args->idx += certSz;
@@ -2416,6 +2416,39 @@ int wolfSSL_dtls_get_drop_stats(WOLFSSL* ssl,
 #endif /* WOLFSSL_DTLS_DROP_STATS */
 
 
+#if defined(WOLFSSL_DTLS13) && defined(WOLFSSL_DTLS13_RTX_STATS)
+
+/* Retransmission statistics of a DTLS 1.3 connection: long timeouts that
+ * resent the flight, records and handshake bytes sent again, and records the
+ * peer acknowledged. Any of the outputs may be NULL. */
+int wolfSSL_dtls13_get_rtx_stats(WOLFSSL* ssl, word32* timeouts,
+                                 word32* records, word32* bytes, word32* acked)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_dtls13_get_rtx_stats");
+
+    if (ssl == NULL)
+        ret = BAD_FUNC_ARG;
+    else {
+        ret = WOLFSSL_SUCCESS;
+        if (timeouts != NULL)
+            *timeouts = ssl->dtls13Rtx.timeoutCount;
+        if (records != NULL)
+            *records = ssl->dtls13Rtx.rtxRecordCount;
+        if (bytes != NULL)
+            *bytes = ssl->dtls13Rtx.rtxByteCount;
+        if (acked != NULL)
+            *acked = ssl->dtls13Rtx.ackedCount;
+    }
+
+    WOLFSSL_LEAVE("wolfSSL_dtls13_get_rtx_stats", ret);
+    return ret;
+}
+
+#endif /* WOLFSSL_DTLS13 && WOLFSSL_DTLS13_RTX_STATS */
+
+
 #if defined(WOLFSSL_MULTICAST)
 
 int wolfSSL_CTX_mcast_set_member_id(WOLFSSL_CTX* ctx, word16 id)
@@ -3198,6 +3231,21 @@ static int wolfSSL_write_internal(WOLFSSL* ssl, const void* data, size_t sz)
         ssl->cbmode = WOLFSSL_CB_WRITE;
     }
     #endif
+#ifdef WOLFSSL_DTLS13
+    if (ssl->options.dtls && IsAtLeastTLSv1_3(ssl->version) &&
+            sz <= INT_MAX) {
+        ret = Dtls13HoldWrite(ssl, (const byte*)data, (word32)sz);
+        if (ret < 0) {
+            ssl->error = ret;
+            WOLFSSL_LEAVE("wolfSSL_write", ret);
+            return WOLFSSL_FATAL_ERROR;
+        }
+        if (ret == 1) {
+            WOLFSSL_LEAVE("wolfSSL_write", (int)sz);
+            return (int)sz;
+        }
+    }
+#endif /* WOLFSSL_DTLS13 */
     ret = SendData(ssl, data, sz);
 
     WOLFSSL_LEAVE("wolfSSL_write", ret);
@@ -4549,6 +4597,16 @@ int wolfSSL_shutdown(WOLFSSL* ssl)
         /* try to send close notify, not an error if can't */
         if (!ssl->options.isClosed && !ssl->options.connReset &&
                                       !ssl->options.sentNotify) {
+        #ifdef WOLFSSL_DTLS13
+            /* writes held back by the write delay go first */
+            if (ssl->options.dtls) {
+                ssl->error = Dtls13FlushWrites(ssl);
+                if (ssl->error < 0) {
+                    WOLFSSL_ERROR(ssl->error);
+                    return WOLFSSL_FATAL_ERROR;
+                }
+            }
+        #endif /* WOLFSSL_DTLS13 */
             ssl->error = SendAlert(ssl, alert_warning, close_notify);
 
             /* the alert is now sent or sitting in the buffer,
@@ -9006,6 +9064,83 @@ int wolfSSL_CTX_set_server_cert_type(WOLFSSL_CTX* ctx,
     return set_cert_type(&ctx->rpkConfig, 0, buf, buflen);
 }
 
+/* Binary search of the CTX raw public key allow-list for a SHA-256 hash.
+ * pos receives the index of the hash, or where it would be inserted.
+ * return 1 when the hash is on the list, otherwise 0.
+ */
+int RpkPinFind(const WOLFSSL_CTX* ctx, const byte* hash, word32* pos)
+{
+    word32 lo = 0;
+    word32 hi = ctx->rpkPinsCnt;
+    word32 mid;
+    int    cmp;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        cmp = XMEMCMP(ctx->rpkPins + mid * WC_SHA256_DIGEST_SIZE, hash,
+                      WC_SHA256_DIGEST_SIZE);
+        if (cmp == 0) {
+            lo = mid;
+            break;
+        }
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (pos != NULL)
+        *pos = lo;
+    return lo < ctx->rpkPinsCnt && XMEMCMP(ctx->rpkPins +
+        lo * WC_SHA256_DIGEST_SIZE, hash, WC_SHA256_DIGEST_SIZE) == 0;
+}
+
+/* Add a peer raw public key to the allow-list of the CTX.
+ * spki is the DER SubjectPublicKeyInfo the peer sends as its certificate;
+ * only its SHA-256 is kept. Once the list is not empty, a peer raw public key
+ * that is not on it fails the handshake. Without a list, a raw public key is
+ * accepted unauthenticated as before.
+ * return WOLFSSL_SUCCESS on success, otherwise negative value.
+ */
+int wolfSSL_CTX_add_rpk_pin(WOLFSSL_CTX* ctx, const unsigned char* spki,
+                            int spkiSz)
+{
+    byte   hash[WC_SHA256_DIGEST_SIZE];
+    byte*  pins;
+    word32 pos;
+
+    if (ctx == NULL || spki == NULL || spkiSz <= 0 ||
+            spkiSz > MAX_CERTIFICATE_SZ)
+        return BAD_FUNC_ARG;
+    if (wc_Sha256Hash(spki, (word32)spkiSz, hash) != 0)
+        return BAD_FUNC_ARG;
+    if (RpkPinFind(ctx, hash, &pos))
+        return WOLFSSL_SUCCESS;
+
+    if (ctx->rpkPinsCnt == ctx->rpkPinsMax) {
+        word32 max = ctx->rpkPinsMax != 0 ? ctx->rpkPinsMax * 2 : 8;
+
+        pins = (byte*)XMALLOC(max * WC_SHA256_DIGEST_SIZE, ctx->heap,
+                              DYNAMIC_TYPE_CERT);
+        if (pins == NULL)
+            return MEMORY_E;
+        if (ctx->rpkPins != NULL) {
+            XMEMCPY(pins, ctx->rpkPins,
+                    ctx->rpkPinsCnt * WC_SHA256_DIGEST_SIZE);
+            XFREE(ctx->rpkPins, ctx->heap, DYNAMIC_TYPE_CERT);
+        }
+        ctx->rpkPins = pins;
+        ctx->rpkPinsMax = max;
+    }
+
+    pins = ctx->rpkPins + pos * WC_SHA256_DIGEST_SIZE;
+    XMEMMOVE(pins + WC_SHA256_DIGEST_SIZE, pins,
+             (ctx->rpkPinsCnt - pos) * WC_SHA256_DIGEST_SIZE);
+    XMEMCPY(pins, hash, WC_SHA256_DIGEST_SIZE);
+    ctx->rpkPinsCnt++;
+
+    return WOLFSSL_SUCCESS;
+}
+
 /* get negotiated certificate type value and return it to the second parameter.
  * cert type value:
  * -1: WOLFSSL_CERT_TYPE_UNKNOWN
@@ -9991,6 +10126,73 @@ void wolfSSL_dtls13_set_send_more_acks(WOLFSSL* ssl, int value)
     if (ssl != NULL)
         ssl->options.dtls13SendMoreAcks = !!value;
 }
+
+/*
+ * Hold ACKs, and the retransmission that answers a peer retransmission, for
+ * up to ms milliseconds so that the records arriving meanwhile are
+ * acknowledged in one ACK. While something is held
+ * wolfSSL_dtls13_use_quick_timeout() returns 1; the application should then
+ * time out after wolfSSL_dtls13_get_ack_delay() ms. 0 (the default) sends
+ * them at once.
+ */
+int wolfSSL_dtls13_set_ack_delay(WOLFSSL* ssl, int ms)
+{
+    if (ssl == NULL || ms < 0 || ms > 0xFFFF)
+        return BAD_FUNC_ARG;
+
+    ssl->dtls13AckDelay = (word16)ms;
+
+    return WOLFSSL_SUCCESS;
+}
+
+int wolfSSL_dtls13_get_ack_delay(WOLFSSL* ssl)
+{
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    return ssl->dtls13AckDelay;
+}
+
+/*
+ * Hold application writes smaller than a record for up to ms milliseconds so
+ * that the writes made meanwhile go out in the same record. wolfSSL_write()
+ * returns the full size for a held write. While something is held
+ * wolfSSL_dtls13_use_quick_timeout() returns 1; the application should then
+ * time out after wolfSSL_dtls13_get_write_delay() ms and call
+ * wolfSSL_dtls_got_timeout(), which sends the record. A write that does not
+ * fit and wolfSSL_shutdown() send it too. 0 (the default) sends every write
+ * at once.
+ */
+int wolfSSL_dtls13_set_write_delay(WOLFSSL* ssl, int ms)
+{
+    if (ssl == NULL || ms < 0 || ms > 0xFFFF)
+        return BAD_FUNC_ARG;
+
+    ssl->dtls13WriteDelay = (word16)ms;
+
+    return WOLFSSL_SUCCESS;
+}
+
+int wolfSSL_dtls13_get_write_delay(WOLFSSL* ssl)
+{
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    return ssl->dtls13WriteDelay;
+}
+
+/*
+ * When this is set, application data after the handshake goes out with the
+ * shortest DTLS 1.3 unified header: an 8-bit sequence number, and no length
+ * when the record is alone in its datagram. That saves 1 to 3 bytes a record.
+ * The peer then recovers the sequence number from the low 8 bits, so more
+ * than 127 records in a row must not get lost.
+ */
+void wolfSSL_dtls13_set_short_header(WOLFSSL* ssl, int value)
+{
+    if (ssl != NULL)
+        ssl->options.dtls13ShortHeader = !!value;
+}
 #endif /* WOLFSSL_DTLS13 */
 
 int wolfSSL_DTLSv1_get_timeout(WOLFSSL* ssl, WOLFSSL_TIMEVAL* timeleft)
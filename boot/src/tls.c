@@ -12807,6 +12807,209 @@ static int TLSX_ServerCertificateType_GetSize(WOLFSSL* ssl, byte msgType)
     #define SCT_PARSE(a, b, c, d) 0
 #endif /* HAVE_RPK */
 
+/******************************************************************************/
+/* Certificate Compression (RFC 8879)                                         */
+/******************************************************************************/
+
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CERT_COMPRESSION)
+
+/* The only algorithm offered is the preset dictionary codec in tls13.c. Its
+ * codepoint is derived from the dictionary (see
+ * wolfSSL_CTX_set_cert_compress_dict()), so peers holding different
+ * dictionaries never negotiate it and fall back to a plain Certificate.
+ * Sent in ClientHello (client accepts compressed server certificates) and in
+ * CertificateRequest (server accepts compressed client certificates).
+ */
+static word16 TLSX_CertCompress_GetSize(WOLFSSL* ssl)
+{
+    (void)ssl;
+
+    /* algorithms<2..2^8-2> with one entry */
+    return OPAQUE8_LEN + OPAQUE16_LEN;
+}
+
+static word16 TLSX_CertCompress_Write(WOLFSSL* ssl, byte* output)
+{
+    output[0] = OPAQUE16_LEN;
+    c16toa(ssl->ctx->certCompAlg, output + OPAQUE8_LEN);
+
+    return OPAQUE8_LEN + OPAQUE16_LEN;
+}
+
+static int TLSX_CertCompress_Parse(WOLFSSL* ssl, const byte* input,
+                                   word16 length, byte msgType)
+{
+    word16 idx;
+    word16 alg;
+
+    if (msgType != client_hello && msgType != certificate_request) {
+        WOLFSSL_ERROR_VERBOSE(EXT_NOT_ALLOWED);
+        return EXT_NOT_ALLOWED;
+    }
+
+    if (length < OPAQUE8_LEN + OPAQUE16_LEN ||
+            input[0] != length - OPAQUE8_LEN || (input[0] & 1) != 0) {
+        return BUFFER_ERROR;
+    }
+
+    /* Not offering it ourselves: the peer never gets to use it. */
+    if (ssl->ctx->certCompDict == NULL)
+        return 0;
+
+    for (idx = OPAQUE8_LEN; idx < length; idx += OPAQUE16_LEN) {
+        ato16(input + idx, &alg);
+        if (alg == ssl->ctx->certCompAlg)
+            ssl->options.certCompPeer = 1;
+    }
+
+    return 0;
+}
+
+    #define CCE_GET_SIZE  TLSX_CertCompress_GetSize
+    #define CCE_WRITE     TLSX_CertCompress_Write
+    #define CCE_PARSE     TLSX_CertCompress_Parse
+#else
+    #define CCE_GET_SIZE(a)  0
+    #define CCE_WRITE(a, b)  0
+    #define CCE_PARSE(a, b, c, d) 0
+#endif /* WOLFSSL_TLS13 && HAVE_CERT_COMPRESSION */
+
+/******************************************************************************/
+/* Cached Information (RFC 7924)                                              */
+/******************************************************************************/
+
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CACHED_INFO)
+
+#if defined(NO_SHA256) || defined(WOLFSSL_ASYNC_CRYPT) || \
+    defined(WOLFSSL_NONBLOCK_OCSP)
+    #error HAVE_CACHED_INFO needs SHA-256 and synchronous certificate \
+           processing
+#endif
+
+#define CACHED_INFO_TYPE_CERT 1
+
+/* The client names the server certificate it already holds by its SHA-256
+ * (see wolfSSL_CTX_UseCachedCert()). A server whose end-entity certificate
+ * has that hash acknowledges in EncryptedExtensions and sends the hash in
+ * place of the certificate and chain.
+ *
+ * CachedObject list<1..2^16-1>: type (1), and from the client only,
+ * hash_value<1..255>.
+ */
+static word16 TLSX_CachedInfo_GetSize(WOLFSSL* ssl)
+{
+    if (ssl->options.side == WOLFSSL_CLIENT_END)
+        return OPAQUE16_LEN + OPAQUE8_LEN + OPAQUE8_LEN + WC_SHA256_DIGEST_SIZE;
+    return OPAQUE16_LEN + OPAQUE8_LEN;
+}
+
+static word16 TLSX_CachedInfo_Write(WOLFSSL* ssl, byte* output)
+{
+    word16 length = TLSX_CachedInfo_GetSize(ssl);
+
+    c16toa(length - OPAQUE16_LEN, output);
+    output[OPAQUE16_LEN] = CACHED_INFO_TYPE_CERT;
+    if (ssl->options.side == WOLFSSL_CLIENT_END) {
+        output[OPAQUE16_LEN + OPAQUE8_LEN] = WC_SHA256_DIGEST_SIZE;
+        XMEMCPY(output + OPAQUE16_LEN + OPAQUE8_LEN + OPAQUE8_LEN,
+                ssl->ctx->cachedCertHash, WC_SHA256_DIGEST_SIZE);
+    }
+
+    return length;
+}
+
+#ifndef NO_WOLFSSL_SERVER
+/* Whether hash is the SHA-256 of the certificate this server sends. */
+static int TLSX_CachedInfo_CertMatch(WOLFSSL* ssl, const byte* hash)
+{
+    byte digest[WC_SHA256_DIGEST_SIZE];
+
+    if (ssl->buffers.certificate == NULL ||
+            ssl->buffers.certificate->buffer == NULL ||
+            ssl->buffers.certificate->length == 0) {
+        return 0;
+    }
+    if (wc_Sha256Hash(ssl->buffers.certificate->buffer,
+            ssl->buffers.certificate->length, digest) != 0) {
+        return 0;
+    }
+    return ConstantCompare(digest, hash, WC_SHA256_DIGEST_SIZE) == 0;
+}
+#endif
+
+static int TLSX_CachedInfo_Parse(WOLFSSL* ssl, const byte* input,
+                                 word16 length, byte msgType)
+{
+    word16 idx = OPAQUE16_LEN;
+    word16 listSz;
+    int    ret = 0;
+
+    if (length < OPAQUE16_LEN + OPAQUE8_LEN)
+        return BUFFER_ERROR;
+    ato16(input, &listSz);
+    if (listSz != length - OPAQUE16_LEN)
+        return BUFFER_ERROR;
+
+#ifndef NO_WOLFSSL_SERVER
+    if (msgType == client_hello) {
+        while (idx < length) {
+            byte type, hashSz;
+
+            if (idx + OPAQUE8_LEN + OPAQUE8_LEN > length)
+                return BUFFER_ERROR;
+            type = input[idx++];
+            hashSz = input[idx++];
+            if (hashSz == 0 || idx + hashSz > length)
+                return BUFFER_ERROR;
+
+            if (type == CACHED_INFO_TYPE_CERT &&
+                    hashSz == WC_SHA256_DIGEST_SIZE &&
+                    !ssl->options.cachedInfoCert &&
+                    TLSX_CachedInfo_CertMatch(ssl, input + idx)) {
+                WOLFSSL_MSG("Client holds our certificate");
+                if (TLSX_Find(ssl->extensions, TLSX_CACHED_INFO) == NULL) {
+                    ret = TLSX_Push(&ssl->extensions, TLSX_CACHED_INFO, ssl,
+                                    ssl->heap);
+                    if (ret != 0)
+                        return ret;
+                }
+                TLSX_SetResponse(ssl, TLSX_CACHED_INFO);
+                ssl->options.cachedInfoCert = 1;
+            }
+            idx += hashSz;
+        }
+        return 0;
+    }
+#endif
+#ifndef NO_WOLFSSL_CLIENT
+    if (msgType == encrypted_extensions) {
+        /* Only an answer to what we offered. */
+        if (ssl->ctx->cachedCert == NULL) {
+            WOLFSSL_ERROR_VERBOSE(EXT_NOT_ALLOWED);
+            return EXT_NOT_ALLOWED;
+        }
+        for (; idx < length; idx++) {
+            if (input[idx] == CACHED_INFO_TYPE_CERT)
+                ssl->options.cachedInfoCert = 1;
+        }
+        return 0;
+    }
+#endif
+
+    (void)ret;
+    WOLFSSL_ERROR_VERBOSE(EXT_NOT_ALLOWED);
+    return EXT_NOT_ALLOWED;
+}
+
+    #define CIE_GET_SIZE  TLSX_CachedInfo_GetSize
+    #define CIE_WRITE     TLSX_CachedInfo_Write
+    #define CIE_PARSE     TLSX_CachedInfo_Parse
+#else
+    #define CIE_GET_SIZE(a)  0
+    #define CIE_WRITE(a, b)  0
+    #define CIE_PARSE(a, b, c, d) 0
+#endif /* WOLFSSL_TLS13 && HAVE_CACHED_INFO */
+
 /******************************************************************************/
 /* TLS Extensions Framework                                                   */
 /******************************************************************************/
@@ -13666,6 +13869,18 @@ void TLSX_FreeAll(TLSX* list, void* heap)
                 WOLFSSL_MSG("Certificate Authorities extension free");
                 break;
     #endif
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                WOLFSSL_MSG("Compress Certificate extension free");
+                /* nothing to do */
+                break;
+    #endif
+    #ifdef HAVE_CACHED_INFO
+            case TLSX_CACHED_INFO:
+                WOLFSSL_MSG("Cached Information extension free");
+                /* nothing to do */
+                break;
+    #endif
 #endif
 #ifdef WOLFSSL_SRTP
             case TLSX_USE_SRTP:
@@ -13863,6 +14078,16 @@ static int TLSX_GetSize(TLSX* list, byte* semaphore, byte msgType,
                 length += CAN_GET_SIZE(extension->data);
                 break;
     #endif
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                length += CCE_GET_SIZE((WOLFSSL*)extension->data);
+                break;
+    #endif
+    #ifdef HAVE_CACHED_INFO
+            case TLSX_CACHED_INFO:
+                length += CIE_GET_SIZE((WOLFSSL*)extension->data);
+                break;
+    #endif
 #endif
 #ifdef WOLFSSL_SRTP
             case TLSX_USE_SRTP:
@@ -14105,6 +14330,18 @@ static int TLSX_Write(TLSX* list, byte* output, byte* semaphore,
                 offset += CAN_WRITE(extension->data, output + offset);
                 break;
     #endif
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                WOLFSSL_MSG("Compress Certificate extension to write");
+                offset += CCE_WRITE((WOLFSSL*)extension->data, output + offset);
+                break;
+    #endif
+    #ifdef HAVE_CACHED_INFO
+            case TLSX_CACHED_INFO:
+                WOLFSSL_MSG("Cached Information extension to write");
+                offset += CIE_WRITE((WOLFSSL*)extension->data, output + offset);
+                break;
+    #endif
 #endif
 #ifdef WOLFSSL_SRTP
             case TLSX_USE_SRTP:
@@ -14628,6 +14865,26 @@ int TLSX_PopulateExtensions(WOLFSSL* ssl, byte isServer)
                     return ret;
             }
         }
+    #endif
+    #if !defined(NO_CERTS) && defined(HAVE_CERT_COMPRESSION)
+        if (IsAtLeastTLSv1_3(ssl->version) &&
+                ssl->ctx->certCompDict != NULL) {
+            WOLFSSL_MSG("Adding compress certificate extension");
+            if ((ret = TLSX_Push(&ssl->extensions,
+                    TLSX_COMPRESS_CERTIFICATE, ssl, ssl->heap)) != 0) {
+                    return ret;
+            }
+        }
+    #endif
+    #if !defined(NO_CERTS) && defined(HAVE_CACHED_INFO)
+        if (!isServer && IsAtLeastTLSv1_3(ssl->version) &&
+                ssl->ctx->cachedCert != NULL) {
+            WOLFSSL_MSG("Adding cached information extension");
+            if ((ret = TLSX_Push(&ssl->extensions,
+                    TLSX_CACHED_INFO, ssl, ssl->heap)) != 0) {
+                    return ret;
+            }
+        }
     #endif
         if (!isServer && IsAtLeastTLSv1_3(ssl->version)) {
             /* Add mandatory TLS v1.3 extension: supported version */
@@ -15157,6 +15414,12 @@ int TLSX_GetRequestSize(WOLFSSL* ssl, byte msgType, word32* pLength)
             TURN_OFF(semaphore,
                     TLSX_ToSemaphore(TLSX_CERTIFICATE_AUTHORITIES));
         }
+#endif
+#ifdef HAVE_CERT_COMPRESSION
+        if (ssl->ctx->certCompDict != NULL) {
+            TURN_OFF(semaphore,
+                    TLSX_ToSemaphore(TLSX_COMPRESS_CERTIFICATE));
+        }
 #endif
         /* TODO: TLSX_SIGNED_CERTIFICATE_TIMESTAMP, OID_FILTERS
          *       TLSX_STATUS_REQUEST
@@ -15342,6 +15605,12 @@ int TLSX_WriteRequest(WOLFSSL* ssl, byte* output, byte msgType, word32* pOffset)
             TURN_OFF(semaphore,
                     TLSX_ToSemaphore(TLSX_CERTIFICATE_AUTHORITIES));
         }
+#endif
+#ifdef HAVE_CERT_COMPRESSION
+        if (ssl->ctx->certCompDict != NULL) {
+            TURN_OFF(semaphore,
+                    TLSX_ToSemaphore(TLSX_COMPRESS_CERTIFICATE));
+        }
 #endif
         /* TODO: TLSX_SIGNED_CERTIFICATE_TIMESTAMP, TLSX_OID_FILTERS
          *       TLSX_STATUS_REQUEST
@@ -16457,6 +16726,34 @@ int TLSX_Parse(WOLFSSL* ssl, const byte* input, word16 length, byte msgType,
                 break;
     #endif
 
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                WOLFSSL_MSG("Compress Certificate extension received");
+            #ifdef WOLFSSL_DEBUG_TLS
+                WOLFSSL_BUFFER(input + offset, size);
+            #endif
+
+                if (!IsAtLeastTLSv1_3(ssl->version))
+                    break;
+
+                ret = CCE_PARSE(ssl, input + offset, size, msgType);
+                break;
+    #endif
+
+    #ifdef HAVE_CACHED_INFO
+            case TLSX_CACHED_INFO:
+                WOLFSSL_MSG("Cached Information extension received");
+            #ifdef WOLFSSL_DEBUG_TLS
+                WOLFSSL_BUFFER(input + offset, size);
+            #endif
+
+                if (!IsAtLeastTLSv1_3(ssl->version))
+                    break;
+
+                ret = CIE_PARSE(ssl, input + offset, size, msgType);
+                break;
+    #endif
+
             case TLSX_KEY_SHARE:
                 WOLFSSL_MSG("Key Share extension received");
             #ifdef WOLFSSL_DEBUG_TLS
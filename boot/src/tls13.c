@@ -3264,8 +3264,14 @@ int BuildTls13Message(WOLFSSL* ssl, byte* output, int outSz, const byte* input,
 
         args->headerSz = RECORD_HEADER_SZ;
 #ifdef WOLFSSL_DTLS13
-        if (ssl->options.dtls)
+        if (ssl->options.dtls) {
             args->headerSz = Dtls13GetRlHeaderLength(ssl, 1);
+            /* Application data is copied in from the caller's buffer, so its
+             * header can be shorter than the space reserved in front. */
+            if (type == application_data && !sizeOnly &&
+                    input != output + args->headerSz)
+                args->headerSz = Dtls13GetAppDataHeaderLength(ssl);
+        }
 #endif /* WOLFSSL_DTLS13 */
 
         args->sz = args->headerSz + (word32)inSz;
@@ -3298,10 +3304,11 @@ int BuildTls13Message(WOLFSSL* ssl, byte* output, int outSz, const byte* input,
             args->sz += ssl->specs.aead_mac_size;
 #ifdef WOLFSSL_DTLS13
             /* Pad to minimum length */
-            if (ssl->options.dtls &&
-                    args->sz < (word32)Dtls13MinimumRecordLength(ssl)) {
-                args->paddingSz = Dtls13MinimumRecordLength(ssl) - args->sz;
-                args->sz = Dtls13MinimumRecordLength(ssl);
+            if (ssl->options.dtls && args->sz <
+                    (word32)Dtls13MinimumRecordLength((word16)args->headerSz)) {
+                args->paddingSz = Dtls13MinimumRecordLength(
+                    (word16)args->headerSz) - args->sz;
+                args->sz = Dtls13MinimumRecordLength((word16)args->headerSz);
             }
 #endif
             if (sizeOnly)
@@ -3321,7 +3328,8 @@ int BuildTls13Message(WOLFSSL* ssl, byte* output, int outSz, const byte* input,
 
             if (ssl->options.dtls) {
 #ifdef WOLFSSL_DTLS13
-                Dtls13RlAddCiphertextHeader(ssl, output, args->size);
+                Dtls13RlAddCiphertextHeader(ssl, output, args->size,
+                    (word16)args->headerSz);
 #endif /* WOLFSSL_DTLS13 */
             }
             else {
@@ -8723,6 +8731,227 @@ static int SetupOcspResp(WOLFSSL* ssl)
 }
 #endif
 
+#ifdef HAVE_CERT_COMPRESSION
+#if defined(NO_SHA256) || defined(WOLFSSL_ASYNC_CRYPT) || \
+    defined(WOLFSSL_NONBLOCK_OCSP)
+    #error HAVE_CERT_COMPRESSION needs SHA-256 and synchronous certificate \
+           processing
+#endif
+
+/* Preset dictionary codec for CompressedCertificate (RFC 8879).
+ *
+ * The dictionary is a certificate both ends already hold (the fleet's CA), so
+ * the issuer name, key identifiers, algorithm identifiers and extension
+ * boilerplate of the certificates sent collapse into back references. The
+ * stream is a sequence of tokens:
+ *   0x00..0x7f  literal run, (t + 1) bytes follow
+ *   0x80..0xff  match of (t & 0x7f) + CERT_COMP_MIN_MATCH bytes, followed by
+ *               a 16-bit distance back into dictionary || output
+ * Decoding needs no memory beyond the output buffer and reads the dictionary
+ * in place, so a device can keep it in flash.
+ */
+#define CERT_COMP_HEADER_SZ   (OPAQUE16_LEN + OPAQUE24_LEN + OPAQUE24_LEN)
+#define CERT_COMP_MIN_MATCH   4
+#define CERT_COMP_MAX_MATCH   (0x7f + CERT_COMP_MIN_MATCH)
+#define CERT_COMP_MAX_LITERAL 0x80
+#define CERT_COMP_HASH_BITS   8
+#define CERT_COMP_MAX_CHAIN   32
+#define CERT_COMP_NO_POS      0xffff
+
+static WC_INLINE word32 CertCompHash(const byte* p)
+{
+    word32 v = ((word32)p[0] << 16) | ((word32)p[1] << 8) | p[2];
+    return (v * 2654435761U) >> (32 - CERT_COMP_HASH_BITS);
+}
+
+static int CertCompEmitLiterals(const byte* lit, word32 litSz, byte* out,
+                                word32* outIdx, word32 outSz)
+{
+    while (litSz > 0) {
+        word32 n = min(litSz, CERT_COMP_MAX_LITERAL);
+        if (*outIdx + 1 + n > outSz)
+            return 0;
+        out[(*outIdx)++] = (byte)(n - 1);
+        XMEMCPY(out + *outIdx, lit, n);
+        *outIdx += n;
+        lit += n;
+        litSz -= n;
+    }
+    return 1;
+}
+
+/* Compress in against dict into out.
+ * returns the compressed size, 0 when it does not fit in outSz and a negative
+ * value on error. */
+static int CertCompress(const byte* dict, word32 dictSz, const byte* in,
+                        word32 inSz, byte* out, word32 outSz, void* heap)
+{
+    word16 head[1 << CERT_COMP_HASH_BITS];
+    word32 total = dictSz + inSz;
+    word32 pos, lit, o = 0;
+    word16* prev;
+    byte* win;
+    int ret = 0;
+
+    (void)heap;
+
+    /* Distances are 16 bits and CERT_COMP_NO_POS marks an empty chain. */
+    if (total >= CERT_COMP_NO_POS)
+        return 0;
+
+    win = (byte*)XMALLOC(total + total * sizeof(word16), heap,
+                         DYNAMIC_TYPE_TMP_BUFFER);
+    if (win == NULL)
+        return MEMORY_E;
+    prev = (word16*)(void*)(win + total);
+    XMEMCPY(win, dict, dictSz);
+    XMEMCPY(win + dictSz, in, inSz);
+    XMEMSET(head, 0xff, sizeof(head));
+
+    for (pos = 0; pos < dictSz && pos + CERT_COMP_MIN_MATCH <= total; pos++) {
+        word32 h = CertCompHash(win + pos);
+        prev[pos] = head[h];
+        head[h] = (word16)pos;
+    }
+
+    pos = lit = dictSz;
+    while (pos < total) {
+        word32 best = 0, dist = 0;
+
+        if (pos + CERT_COMP_MIN_MATCH <= total) {
+            word32 maxLen = min(total - pos, CERT_COMP_MAX_MATCH);
+            word32 h = CertCompHash(win + pos);
+            word16 cand = head[h];
+            int chain = CERT_COMP_MAX_CHAIN;
+
+            while (cand != CERT_COMP_NO_POS && chain-- > 0) {
+                word32 l = 0;
+                while (l < maxLen && win[cand + l] == win[pos + l])
+                    l++;
+                if (l > best) {
+                    best = l;
+                    dist = pos - cand;
+                    if (l == maxLen)
+                        break;
+                }
+                cand = prev[cand];
+            }
+        }
+
+        if (best >= CERT_COMP_MIN_MATCH) {
+            word32 end = pos + best;
+
+            if (!CertCompEmitLiterals(win + lit, pos - lit, out, &o, outSz) ||
+                    o + 1 + OPAQUE16_LEN > outSz) {
+                break;
+            }
+            out[o++] = (byte)(0x80 | (best - CERT_COMP_MIN_MATCH));
+            c16toa((word16)dist, out + o);
+            o += OPAQUE16_LEN;
+            for (; pos < end; pos++) {
+                if (pos + CERT_COMP_MIN_MATCH <= total) {
+                    word32 h = CertCompHash(win + pos);
+                    prev[pos] = head[h];
+                    head[h] = (word16)pos;
+                }
+            }
+            lit = pos;
+        }
+        else {
+            if (pos + CERT_COMP_MIN_MATCH <= total) {
+                word32 h = CertCompHash(win + pos);
+                prev[pos] = head[h];
+                head[h] = (word16)pos;
+            }
+            pos++;
+        }
+    }
+
+    if (pos == total &&
+            CertCompEmitLiterals(win + lit, pos - lit, out, &o, outSz)) {
+        ret = (int)o;
+    }
+
+    XFREE(win, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    return ret;
+}
+
+/* Decompress in against dict into exactly outSz bytes of out. */
+static int CertDecompress(const byte* dict, word32 dictSz, const byte* in,
+                          word32 inSz, byte* out, word32 outSz)
+{
+    word32 i = 0, o = 0;
+
+    while (i < inSz) {
+        byte t = in[i++];
+
+        if (t < 0x80) {
+            word32 n = (word32)t + 1;
+            if (n > inSz - i || n > outSz - o)
+                return ZLIB_DECOMPRESS_ERROR;
+            XMEMCPY(out + o, in + i, n);
+            i += n;
+            o += n;
+        }
+        else {
+            word32 n = (word32)(t & 0x7f) + CERT_COMP_MIN_MATCH;
+            word16 dist;
+
+            if (OPAQUE16_LEN > inSz - i)
+                return ZLIB_DECOMPRESS_ERROR;
+            ato16(in + i, &dist);
+            i += OPAQUE16_LEN;
+            if (dist == 0 || dist > dictSz + o || n > outSz - o)
+                return ZLIB_DECOMPRESS_ERROR;
+            /* Byte by byte: the match may overlap its own output. */
+            for (; n > 0; n--, o++) {
+                word32 src = dictSz + o - dist;
+                out[o] = src < dictSz ? dict[src] : out[src - dictSz];
+            }
+        }
+    }
+
+    return o == outSz ? 0 : ZLIB_DECOMPRESS_ERROR;
+}
+
+/* Turn the Certificate message built at output (body from bodyIdx up to
+ * *idx) into a CompressedCertificate when the peer takes our dictionary and
+ * the result is smaller. On success *idx is the new end and *type the
+ * message type to send. */
+static int Tls13CompressCertificate(WOLFSSL* ssl, byte* output,
+                                    word32 bodyIdx, word32* idx, byte* type)
+{
+    word32 bodySz = *idx - bodyIdx;
+    byte* comp;
+    int sz;
+
+    if (!ssl->options.certCompPeer || ssl->ctx->certCompDict == NULL ||
+            bodySz <= CERT_COMP_HEADER_SZ + 1) {
+        return 0;
+    }
+
+    comp = (byte*)XMALLOC(bodySz, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    if (comp == NULL)
+        return MEMORY_E;
+
+    sz = CertCompress(ssl->ctx->certCompDict, ssl->ctx->certCompDictSz,
+                      output + bodyIdx, bodySz, comp,
+                      bodySz - CERT_COMP_HEADER_SZ - 1, ssl->heap);
+    if (sz > 0) {
+        WOLFSSL_MSG("Sending CompressedCertificate");
+        c16toa(ssl->ctx->certCompAlg, output + bodyIdx);
+        c32to24(bodySz, output + bodyIdx + OPAQUE16_LEN);
+        c32to24((word32)sz, output + bodyIdx + OPAQUE16_LEN + OPAQUE24_LEN);
+        XMEMCPY(output + bodyIdx + CERT_COMP_HEADER_SZ, comp, (size_t)sz);
+        *idx = bodyIdx + CERT_COMP_HEADER_SZ + (word32)sz;
+        *type = compressed_certificate;
+    }
+
+    XFREE(comp, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    return sz < 0 ? sz : 0;
+}
+#endif /* HAVE_CERT_COMPRESSION */
+
 /* handle generation TLS v1.3 certificate (11) */
 /* Send the certificate for this end and any CAs that help with validation.
  * This message is always encrypted in TLS v1.3.
@@ -8742,11 +8971,16 @@ static int SendTls13Certificate(WOLFSSL* ssl)
     word32 idx = 0;
     word32 offset = OPAQUE16_LEN;
     byte*  p = NULL;
+    byte*  certData = NULL;
+    word32 chainCnt = 0;
     byte   certReqCtxLen = 0;
     sword32 length;
 #ifdef WOLFSSL_POST_HANDSHAKE_AUTH
     byte*  certReqCtx = NULL;
 #endif
+#ifdef HAVE_CACHED_INFO
+    byte   certHash[WC_SHA256_DIGEST_SIZE];
+#endif
 
 #ifdef OPENSSL_EXTRA
     WOLFSSL_X509* x509 = NULL;
@@ -8797,7 +9031,21 @@ static int SendTls13Certificate(WOLFSSL* ssl)
             return NO_CERT_ERROR;
         }
         /* Certificate Data */
+        certData = ssl->buffers.certificate->buffer;
         certSz = ssl->buffers.certificate->length;
+        chainCnt = (word32)ssl->buffers.certChainCnt;
+    #ifdef HAVE_CACHED_INFO
+        /* The client holds this certificate: send its hash and no chain. */
+        if (ssl->options.side == WOLFSSL_SERVER_END &&
+                ssl->options.cachedInfoCert) {
+            ret = wc_Sha256Hash(certData, certSz, certHash);
+            if (ret != 0)
+                return ret;
+            certData = certHash;
+            certSz = WC_SHA256_DIGEST_SIZE;
+            chainCnt = 0;
+        }
+    #endif
         /* Cert Req Ctx Len | Cert Req Ctx | Cert List Len | Cert Data Len */
         headerSz = OPAQUE8_LEN + certReqCtxLen + CERT_HEADER_SZ +
                    CERT_HEADER_SZ;
@@ -8815,7 +9063,7 @@ static int SendTls13Certificate(WOLFSSL* ssl)
                 return ret;
 
             ret = WriteCSRToBuffer(ssl, &ssl->buffers.certExts[0], &extSz[0],
-                    1 /* +1 for leaf */ + ssl->buffers.certChainCnt);
+                    (word16)(1 /* +1 for leaf */ + chainCnt));
             if (ret < 0)
                 return ret;
             totalextSz += ret;
@@ -8827,7 +9075,7 @@ static int SendTls13Certificate(WOLFSSL* ssl)
             /* Leaf cert empty extension size */
             totalextSz += OPAQUE16_LEN;
             /* chain cert empty extension size */
-            totalextSz += OPAQUE16_LEN * ssl->buffers.certChainCnt;
+            totalextSz += OPAQUE16_LEN * chainCnt;
         }
 
         /* Length of message data with one certificate and extensions. */
@@ -8836,7 +9084,7 @@ static int SendTls13Certificate(WOLFSSL* ssl)
         listSz = CERT_HEADER_SZ + certSz + totalextSz;
 
         /* Send rest of chain if sending cert (chain has leading size/s). */
-        if (certSz > 0 && ssl->buffers.certChainCnt > 0) {
+        if (certSz > 0 && chainCnt > 0) {
             p = ssl->buffers.certChain->buffer;
             /* Chain length including extensions. */
             certChainSz = ssl->buffers.certChain->length;
@@ -8862,6 +9110,10 @@ static int SendTls13Certificate(WOLFSSL* ssl)
         word32 fragSz = 0;
         word32 i = RECORD_HEADER_SZ;
         int    sendSz = RECORD_HEADER_SZ;
+        byte   msgType = certificate;
+    #ifdef HAVE_CERT_COMPRESSION
+        word32 bodyIdx = 0;
+    #endif
 
 #ifdef WOLFSSL_DTLS13
         if (ssl->options.dtls) {
@@ -8894,6 +9146,9 @@ static int SendTls13Certificate(WOLFSSL* ssl)
                 i += DTLS_HANDSHAKE_EXTRA;
             }
 #endif /* WOLFSSL_DTLS13 */
+        #ifdef HAVE_CERT_COMPRESSION
+            bodyIdx = i;
+        #endif
         }
         else {
             fragSz = min((word32)length, maxFragment);
@@ -8941,7 +9196,7 @@ static int SendTls13Certificate(WOLFSSL* ssl)
         if (extIdx == 0) {
             if (certSz > 0 && ssl->fragOffset < certSz + extSz[0]) {
                 /* Put in the leaf certificate with extensions. */
-                word32 copySz = AddCertExt(ssl, ssl->buffers.certificate->buffer,
+                word32 copySz = AddCertExt(ssl, certData,
                                 certSz, extSz[0], ssl->fragOffset, fragSz,
                                 output + i, 0);
                 i += copySz;
@@ -8995,17 +9250,33 @@ static int SendTls13Certificate(WOLFSSL* ssl)
             return BUFFER_E;
         }
 
+    #ifdef HAVE_CERT_COMPRESSION
+        /* Only a message that is whole in this buffer can be compressed. */
+        if (bodyIdx != 0 && length == 0) {
+            ret = Tls13CompressCertificate(ssl, output, bodyIdx, &i, &msgType);
+            if (ret != 0)
+                return ret;
+            if (msgType == compressed_certificate) {
+                AddTls13FragHeaders(output, i - bodyIdx, 0, i - bodyIdx,
+                                    msgType, ssl);
+            }
+        }
+    #endif
+
 #ifdef WOLFSSL_DTLS13
         if (ssl->options.dtls) {
             /* DTLS1.3 uses a separate variable and logic for fragments */
             ssl->options.buildingMsg = 0;
             ssl->fragOffset = 0;
             ret = Dtls13HandshakeSend(ssl, output, (word16)sendSz, (word16)i,
-                                      certificate, 1);
+                                      (enum HandShakeType)msgType, 1);
         }
         else
 #endif /* WOLFSSL_DTLS13 */
         {
+            /* The message type is already in the handshake header. */
+            (void)msgType;
+
             /* This message is always encrypted. */
             sendSz = BuildTls13Message(ssl, output, sendSz,
                 output + RECORD_HEADER_SZ, (int)(i - RECORD_HEADER_SZ),
@@ -9963,6 +10234,78 @@ static int DoTls13Certificate(WOLFSSL* ssl, byte* input, word32* inOutIdx,
 
     return ret;
 }
+
+#ifdef HAVE_CERT_COMPRESSION
+/* handle processing TLS v1.3 compressed_certificate (25) */
+/* Decompress a CompressedCertificate with our dictionary and process the
+ * result as a Certificate message. The decompressed copy only lives for the
+ * call so certificate processing must not suspend.
+ *
+ * ssl       The SSL/TLS object.
+ * input     The message buffer.
+ * inOutIdx  On entry, the index into the message buffer of the message.
+ *           On exit, the index of byte after the message.
+ * totalSz   The length of the current handshake message.
+ * returns 0 on success and otherwise failure.
+ */
+static int DoTls13CompressedCertificate(WOLFSSL* ssl, byte* input,
+                                        word32* inOutIdx, word32 totalSz)
+{
+    int    ret;
+    word32 begin = *inOutIdx;
+    word32 idx = 0;
+    word32 uncompSz, compSz;
+    word16 alg;
+    byte*  cert;
+
+    WOLFSSL_ENTER("DoTls13CompressedCertificate");
+
+    if (totalSz < CERT_COMP_HEADER_SZ)
+        return BUFFER_ERROR;
+    ato16(input + begin, &alg);
+    c24to32(input + begin + OPAQUE16_LEN, &uncompSz);
+    c24to32(input + begin + OPAQUE16_LEN + OPAQUE24_LEN, &compSz);
+    if (compSz != totalSz - CERT_COMP_HEADER_SZ)
+        return BUFFER_ERROR;
+
+    /* Only the algorithm we offered, and never more than a certificate
+     * message can hold. */
+    if (alg != ssl->ctx->certCompAlg || uncompSz == 0 ||
+            uncompSz > MAX_CERTIFICATE_SZ) {
+        WOLFSSL_MSG("CompressedCertificate algorithm or length bad");
+        SendAlert(ssl, alert_fatal, bad_certificate);
+        WOLFSSL_ERROR_VERBOSE(ZLIB_DECOMPRESS_ERROR);
+        return ZLIB_DECOMPRESS_ERROR;
+    }
+
+    cert = (byte*)XMALLOC(uncompSz, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    if (cert == NULL)
+        return MEMORY_E;
+
+    ret = CertDecompress(ssl->ctx->certCompDict, ssl->ctx->certCompDictSz,
+                         input + begin + CERT_COMP_HEADER_SZ, compSz, cert,
+                         uncompSz);
+    if (ret != 0) {
+        WOLFSSL_MSG("CompressedCertificate does not decompress");
+        SendAlert(ssl, alert_fatal, bad_certificate);
+        WOLFSSL_ERROR_VERBOSE(ret);
+    }
+    else {
+        ret = DoTls13Certificate(ssl, cert, &idx, uncompSz);
+    }
+
+    XFREE(cert, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+
+    if (ret == 0) {
+        *inOutIdx = begin + totalSz;
+        if (IsEncryptionOn(ssl, 0))
+            *inOutIdx += ssl->keys.padSz;
+    }
+
+    WOLFSSL_LEAVE("DoTls13CompressedCertificate", ret);
+    return ret;
+}
+#endif /* HAVE_CERT_COMPRESSION */
 #endif
 
 #if !defined(NO_RSA) || defined(HAVE_ECC) || defined(HAVE_ED25519) || \
@@ -12187,6 +12530,18 @@ static int SendTls13NewSessionTicket(WOLFSSL* ssl)
  */
 static int SanityCheckTls13MsgReceived(WOLFSSL* ssl, byte type)
 {
+#ifdef HAVE_CERT_COMPRESSION
+    /* Stands in for Certificate, but only when we offered to take it. */
+    if (type == compressed_certificate) {
+        if (ssl->ctx->certCompDict == NULL) {
+            WOLFSSL_MSG("CompressedCertificate not offered");
+            WOLFSSL_ERROR_VERBOSE(SANITY_MSG_E);
+            return SANITY_MSG_E;
+        }
+        type = certificate;
+    }
+#endif
+
     /* verify not a duplicate, mark received, check state */
     switch (type) {
 
@@ -12742,7 +13097,11 @@ int DoTls13HandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
 
     if (ssl->options.handShakeState == HANDSHAKE_DONE &&
             type != session_ticket && type != certificate_request &&
-            type != certificate && type != key_update && type != finished) {
+            type != certificate && type != key_update && type != finished
+        #ifdef HAVE_CERT_COMPRESSION
+            && type != compressed_certificate
+        #endif
+            ) {
         WOLFSSL_MSG("HandShake message after handshake complete");
         SendAlert(ssl, alert_fatal, unexpected_message);
         WOLFSSL_ERROR_VERBOSE(OUT_OF_ORDER_E);
@@ -12883,6 +13242,12 @@ int DoTls13HandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
         WOLFSSL_MSG("processing certificate");
         ret = DoTls13Certificate(ssl, input, inOutIdx, size);
         break;
+    #ifdef HAVE_CERT_COMPRESSION
+    case compressed_certificate:
+        WOLFSSL_MSG("processing compressed certificate");
+        ret = DoTls13CompressedCertificate(ssl, input, inOutIdx, size);
+        break;
+    #endif
 #endif
 
 #if !defined(NO_RSA) || defined(HAVE_ECC) || defined(HAVE_ED25519) || \
@@ -13789,6 +14154,42 @@ int wolfSSL_UseKeyShare(WOLFSSL* ssl, word16 group)
     return WOLFSSL_SUCCESS;
 }
 
+/* Create the key share entry for the group the server selected in an earlier
+ * connection, as remembered in session, so that a full handshake does not
+ * need a HelloRetryRequest to find it. The session is not resumed.
+ *
+ * ssl      The SSL/TLS object.
+ * session  A session from a previous connection to the same server.
+ * returns WOLFSSL_SUCCESS when the share was created, WOLFSSL_FAILURE when the
+ * session names no group or one not enabled on ssl, otherwise failure.
+ */
+int wolfSSL_UseSessionKeyShare(WOLFSSL* ssl, WOLFSSL_SESSION* session)
+{
+    word16 group;
+
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+    if (ssl->options.side == WOLFSSL_SERVER_END)
+        return SIDE_ERROR;
+
+    session = ClientSessionToSession(session);
+    if (session == NULL || session->namedGroup == 0)
+        return WOLFSSL_FAILURE;
+    group = session->namedGroup;
+
+    if (ssl->numGroups > 0) {
+        int i;
+        for (i = 0; i < ssl->numGroups; i++) {
+            if (ssl->group[i] == group)
+                break;
+        }
+        if (i == ssl->numGroups)
+            return WOLFSSL_FAILURE;
+    }
+
+    return wolfSSL_UseKeyShare(ssl, group);
+}
+
 /* Send no key share entries - use HelloRetryRequest to negotiate shared group.
  *
  * ssl    The SSL/TLS object.
@@ -13837,6 +14238,75 @@ int wolfSSL_CTX_UseCKS(WOLFSSL_CTX* ctx, byte *sigSpec, word16 sigSpecSz)
 }
 #endif /* WOLFSSL_DUAL_ALG_CERTS */
 
+#ifdef HAVE_CERT_COMPRESSION
+/* Offer and accept CompressedCertificate (RFC 8879) against a preset
+ * dictionary, typically the CA certificate both ends already hold. The
+ * algorithm codepoint is taken from the private use range and derived from a
+ * hash of the dictionary so ends with different dictionaries never agree on
+ * it. The dictionary is not copied and must outlive ctx.
+ *
+ * ctx     The SSL/TLS CTX object.
+ * dict    The dictionary. NULL turns compression off.
+ * dictSz  The length of the dictionary in bytes.
+ * returns BAD_FUNC_ARG on bad arguments and WOLFSSL_SUCCESS otherwise.
+ */
+int wolfSSL_CTX_set_cert_compress_dict(WOLFSSL_CTX* ctx,
+                                       const unsigned char* dict, word32 dictSz)
+{
+    byte digest[WC_SHA256_DIGEST_SIZE];
+
+    if (ctx == NULL || !IsAtLeastTLSv1_3(ctx->method->version) ||
+            (dict != NULL && (dictSz == 0 || dictSz >= CERT_COMP_NO_POS)))
+        return BAD_FUNC_ARG;
+
+    if (dict == NULL) {
+        ctx->certCompDict = NULL;
+        ctx->certCompDictSz = 0;
+        ctx->certCompAlg = 0;
+        return WOLFSSL_SUCCESS;
+    }
+
+    if (wc_Sha256Hash(dict, dictSz, digest) != 0)
+        return BAD_FUNC_ARG;
+
+    ctx->certCompDict = dict;
+    ctx->certCompDictSz = dictSz;
+    ctx->certCompAlg = (word16)(0xC000 |
+                                (((word16)digest[0] << 8 | digest[1]) & 0x3fff));
+    return WOLFSSL_SUCCESS;
+}
+#endif /* HAVE_CERT_COMPRESSION */
+
+#ifdef HAVE_CACHED_INFO
+/* Tell servers which certificate this client already holds (RFC 7924
+ * cached_info). A server sending that certificate replaces it with its
+ * SHA-256, and the held DER is processed in its place. Load the same DER with
+ * wolfSSL_CTX_trust_peer_buffer() to also skip verifying its signature. The
+ * certificate is not copied and must outlive ctx.
+ *
+ * ctx    The SSL/TLS CTX object.
+ * der    The DER encoded server certificate. NULL stops offering it.
+ * derSz  The length of the certificate in bytes.
+ * returns BAD_FUNC_ARG on bad arguments, SIDE_ERROR for a server CTX and
+ * WOLFSSL_SUCCESS otherwise.
+ */
+int wolfSSL_CTX_UseCachedCert(WOLFSSL_CTX* ctx, const unsigned char* der,
+                              word32 derSz)
+{
+    if (ctx == NULL || !IsAtLeastTLSv1_3(ctx->method->version) ||
+            (der != NULL && (derSz == 0 || derSz > MAX_CERTIFICATE_SZ)))
+        return BAD_FUNC_ARG;
+    if (ctx->method->side == WOLFSSL_SERVER_END)
+        return SIDE_ERROR;
+
+    if (der != NULL && wc_Sha256Hash(der, derSz, ctx->cachedCertHash) != 0)
+        return BAD_FUNC_ARG;
+    ctx->cachedCert = der;
+    ctx->cachedCertSz = der != NULL ? derSz : 0;
+    return WOLFSSL_SUCCESS;
+}
+#endif /* HAVE_CACHED_INFO */
+
 /* Do not send a ticket after TLS v1.3 handshake for resumption.
  *
  * ctx  The SSL/TLS CTX object.
@@ -723,7 +723,8 @@ int EmbedReceiveFrom(WOLFSSL *ssl, char *buf, int sz, void *ctx)
             return ret;
 #endif
         doDtlsTimeout = doDtlsTimeout ||
-            (ssl->dtls13FastTimeout && ssl->dtls13Rtx.seenRecords != NULL);
+            (ssl->dtls13FastTimeout && ssl->dtls13Rtx.seenRecords != NULL) ||
+            ssl->dtls13HeldWrites.length > 0;
 #ifdef WOLFSSL_RW_THREADED
         wc_UnLockMutex(&ssl->dtls13Rtx.mutex);
 #endif
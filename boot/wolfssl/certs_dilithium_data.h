@@ -125,4 +125,82 @@ static const unsigned char client_key_dilithium_der[] = {
 };
 static const unsigned int client_key_dilithium_der_len = 121;
 
+static const unsigned char server_cert_dilithium_der[] = {
+    0x30, 0x82, 0x02, 0x52, 0x30, 0x82, 0x01, 0xf9, 0xa0, 0x03, 0x02, 0x01,
+    0x02, 0x02, 0x14, 0x5f, 0x22, 0x98, 0x8b, 0xad, 0x9f, 0xfe, 0x55, 0xc8,
+    0xcd, 0x47, 0x22, 0x2f, 0x29, 0x96, 0x61, 0xea, 0xb3, 0x57, 0x88, 0x30,
+    0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30,
+    0x6a, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02,
+    0x55, 0x53, 0x31, 0x0e, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x04, 0x08, 0x0c,
+    0x05, 0x53, 0x74, 0x61, 0x74, 0x65, 0x31, 0x0d, 0x30, 0x0b, 0x06, 0x03,
+    0x55, 0x04, 0x07, 0x0c, 0x04, 0x43, 0x69, 0x74, 0x79, 0x31, 0x12, 0x30,
+    0x10, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x09, 0x4c, 0x69, 0x74, 0x65,
+    0x58, 0x2d, 0x50, 0x51, 0x43, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55,
+    0x04, 0x0b, 0x0c, 0x02, 0x43, 0x41, 0x31, 0x1b, 0x30, 0x19, 0x06, 0x03,
+    0x55, 0x04, 0x03, 0x0c, 0x12, 0x4c, 0x69, 0x74, 0x65, 0x58, 0x20, 0x44,
+    0x69, 0x6c, 0x69, 0x74, 0x68, 0x69, 0x75, 0x6d, 0x20, 0x43, 0x41, 0x30,
+    0x1e, 0x17, 0x0d, 0x32, 0x35, 0x31, 0x32, 0x30, 0x35, 0x31, 0x31, 0x31,
+    0x32, 0x35, 0x36, 0x5a, 0x17, 0x0d, 0x33, 0x35, 0x31, 0x32, 0x30, 0x33,
+    0x31, 0x31, 0x31, 0x32, 0x35, 0x36, 0x5a, 0x30, 0x72, 0x31, 0x0b, 0x30,
+    0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x55, 0x53, 0x31, 0x0e,
+    0x30, 0x0c, 0x06, 0x03, 0x55, 0x04, 0x08, 0x0c, 0x05, 0x53, 0x74, 0x61,
+    0x74, 0x65, 0x31, 0x0d, 0x30, 0x0b, 0x06, 0x03, 0x55, 0x04, 0x07, 0x0c,
+    0x04, 0x43, 0x69, 0x74, 0x79, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03, 0x55,
+    0x04, 0x0a, 0x0c, 0x09, 0x4c, 0x69, 0x74, 0x65, 0x58, 0x2d, 0x50, 0x51,
+    0x43, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x03, 0x55, 0x04, 0x0b, 0x0c, 0x06,
+    0x53, 0x65, 0x72, 0x76, 0x65, 0x72, 0x31, 0x1f, 0x30, 0x1d, 0x06, 0x03,
+    0x55, 0x04, 0x03, 0x0c, 0x16, 0x4c, 0x69, 0x74, 0x65, 0x58, 0x20, 0x44,
+    0x69, 0x6c, 0x69, 0x74, 0x68, 0x69, 0x75, 0x6d, 0x20, 0x53, 0x65, 0x72,
+    0x76, 0x65, 0x72, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48,
+    0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03,
+    0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x5b, 0x7b, 0xf1, 0x71, 0xca, 0x9e,
+    0xee, 0xbe, 0x0d, 0xea, 0xc5, 0x9e, 0xd3, 0x87, 0x76, 0x79, 0xb6, 0x17,
+    0xff, 0xfd, 0xb3, 0xa2, 0x54, 0x2c, 0x41, 0x2c, 0xc4, 0xde, 0xc7, 0x3f,
+    0xbc, 0xea, 0x8a, 0x9e, 0x05, 0xe9, 0xec, 0x52, 0xac, 0x75, 0x74, 0x6d,
+    0xda, 0x42, 0x99, 0x04, 0x2a, 0xfc, 0xd3, 0x08, 0x4a, 0xbf, 0x92, 0xe5,
+    0x9d, 0x94, 0x2f, 0x4c, 0x57, 0x61, 0xa4, 0x4e, 0x0c, 0x17, 0xa3, 0x75,
+    0x30, 0x73, 0x30, 0x0c, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff,
+    0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01,
+    0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x05, 0xa0, 0x30, 0x13, 0x06, 0x03,
+    0x55, 0x1d, 0x25, 0x04, 0x0c, 0x30, 0x0a, 0x06, 0x08, 0x2b, 0x06, 0x01,
+    0x05, 0x05, 0x07, 0x03, 0x01, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e,
+    0x04, 0x16, 0x04, 0x14, 0x15, 0x28, 0x71, 0x20, 0xeb, 0x24, 0xba, 0x7a,
+    0xda, 0xa8, 0x83, 0x2b, 0xa0, 0x58, 0x5f, 0x49, 0x37, 0xe6, 0xe1, 0x98,
+    0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80,
+    0x14, 0x95, 0x39, 0xc9, 0x22, 0xbd, 0xe3, 0xd1, 0xbf, 0x3c, 0x20, 0x6b,
+    0xf5, 0x10, 0xb6, 0x6b, 0x08, 0x17, 0x70, 0x19, 0x54, 0x30, 0x0a, 0x06,
+    0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x47, 0x00,
+    0x30, 0x44, 0x02, 0x20, 0x19, 0xc2, 0xa7, 0xb5, 0x1e, 0x44, 0xc0, 0xf3,
+    0xf5, 0x97, 0x11, 0x38, 0x85, 0xc3, 0x8a, 0x12, 0xc2, 0xea, 0x94, 0xe2,
+    0xd6, 0x64, 0xbb, 0x2a, 0x6a, 0x0f, 0x35, 0xfa, 0xb1, 0x9b, 0x4e, 0xf8,
+    0x02, 0x20, 0x1c, 0xf8, 0x40, 0xca, 0x79, 0xff, 0x70, 0x8d, 0xe3, 0x42,
+    0xa1, 0x4f, 0x0d, 0xe1, 0x51, 0xd5, 0xcc, 0xf6, 0x27, 0xa6, 0x8c, 0x82,
+    0x55, 0x52, 0xb1, 0x34, 0x41, 0xd2, 0xb0, 0xa7, 0xff, 0x44
+};
+static const unsigned int server_cert_dilithium_der_len = 598;
+
+static const unsigned char client_rpk_dilithium_der[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02,
+    0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03,
+    0x42, 0x00, 0x04, 0xcb, 0x6e, 0x05, 0x26, 0xc9, 0xb4, 0xec, 0xb0, 0xcf,
+    0xef, 0xf5, 0xd7, 0x9e, 0x87, 0x64, 0x29, 0x78, 0x74, 0x0c, 0x9c, 0x4a,
+    0x53, 0x1c, 0xf5, 0xa3, 0x57, 0x5f, 0xef, 0x8a, 0xff, 0x86, 0xa0, 0x29,
+    0xf6, 0x52, 0xb7, 0xf3, 0xd1, 0x20, 0xc4, 0x09, 0x91, 0x25, 0xa8, 0x33,
+    0x73, 0xcc, 0x8a, 0xf9, 0x91, 0x9c, 0xf6, 0x64, 0xfc, 0x8e, 0x59, 0xc9,
+    0x69, 0x5a, 0x16, 0x91, 0xd4, 0x0b, 0x51
+};
+static const unsigned int client_rpk_dilithium_der_len = 91;
+
+static const unsigned char server_rpk_dilithium_der[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02,
+    0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03,
+    0x42, 0x00, 0x04, 0x5b, 0x7b, 0xf1, 0x71, 0xca, 0x9e, 0xee, 0xbe, 0x0d,
+    0xea, 0xc5, 0x9e, 0xd3, 0x87, 0x76, 0x79, 0xb6, 0x17, 0xff, 0xfd, 0xb3,
+    0xa2, 0x54, 0x2c, 0x41, 0x2c, 0xc4, 0xde, 0xc7, 0x3f, 0xbc, 0xea, 0x8a,
+    0x9e, 0x05, 0xe9, 0xec, 0x52, 0xac, 0x75, 0x74, 0x6d, 0xda, 0x42, 0x99,
+    0x04, 0x2a, 0xfc, 0xd3, 0x08, 0x4a, 0xbf, 0x92, 0xe5, 0x9d, 0x94, 0x2f,
+    0x4c, 0x57, 0x61, 0xa4, 0x4e, 0x0c, 0x17
+};
+static const unsigned int server_rpk_dilithium_der_len = 91;
+
 #endif /* CERTS_DILITHIUM_DATA_H */
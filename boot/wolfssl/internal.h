@@ -2945,6 +2945,8 @@ typedef struct Options Options;
 #define TLSXT_SERVER_CERTIFICATE         0x0014 /* RFC8446 */
 #define TLSXT_ENCRYPT_THEN_MAC           0x0016 /* RFC 7366 */
 #define TLSXT_EXTENDED_MASTER_SECRET     0x0017 /* HELLO_EXT_EXTMS */
+#define TLSXT_CACHED_INFO                0x0019 /* RFC 7924 */
+#define TLSXT_COMPRESS_CERTIFICATE       0x001b /* RFC 8879 */
 #define TLSXT_SESSION_TICKET             0x0023
 #define TLSXT_PRE_SHARED_KEY             0x0029
 #define TLSXT_EARLY_DATA                 0x002a
@@ -2991,6 +2993,12 @@ typedef enum {
     TLSX_ENCRYPT_THEN_MAC           = TLSXT_ENCRYPT_THEN_MAC,
 #endif
     TLSX_EXTENDED_MASTER_SECRET     = TLSXT_EXTENDED_MASTER_SECRET,
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CACHED_INFO)
+    TLSX_CACHED_INFO                = TLSXT_CACHED_INFO,
+#endif
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CERT_COMPRESSION)
+    TLSX_COMPRESS_CERTIFICATE       = TLSXT_COMPRESS_CERTIFICATE,
+#endif
     TLSX_SESSION_TICKET             = TLSXT_SESSION_TICKET,
 #ifdef WOLFSSL_TLS13
     #ifdef WOLFSSL_EARLY_DATA
@@ -3892,6 +3900,9 @@ struct WOLFSSL_CTX {
 #if defined(HAVE_RPK)
     RpkConfig   rpkConfig;
     RpkState    rpkState;
+    byte*       rpkPins;        /* sorted SHA-256 of allowed peer keys */
+    word32      rpkPinsCnt;
+    word32      rpkPinsMax;
 #endif /* HAVE_RPK */
 #ifdef WOLFSSL_SRTP
     word16      dtlsSrtpProfiles;  /* DTLS-with-SRTP mode
@@ -4194,6 +4205,16 @@ struct WOLFSSL_CTX {
     byte *sigSpec;
     word16 sigSpecSz;
 #endif
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CERT_COMPRESSION)
+    const byte* certCompDict;   /* This pointer never owns the memory. */
+    word32      certCompDictSz;
+    word16      certCompAlg;    /* private-use codepoint for certCompDict */
+#endif
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CACHED_INFO)
+    const byte* cachedCert;     /* This pointer never owns the memory. */
+    word32      cachedCertSz;
+    byte        cachedCertHash[WC_SHA256_DIGEST_SIZE];
+#endif
 #if defined(WOLFSSL_SYS_CRYPTO_POLICY)
     int secLevel; /* The security level of system-wide crypto policy. */
 #endif /* WOLFSSL_SYS_CRYPTO_POLICY */
@@ -5064,6 +5085,7 @@ struct Options {
 #ifdef WOLFSSL_DTLS13
     word16            dtls13SendMoreAcks:1;  /* Send more acks during the
                                               * handshake process */
+    word16            dtls13ShortHeader:1;   /* 8-bit seq on app data */
 #ifdef WOLFSSL_DTLS13_NO_HRR_ON_RESUME
     word16            dtls13NoHrrOnResume:1;
 #endif
@@ -5112,6 +5134,14 @@ struct Options {
     RpkConfig         rpkConfig;
     RpkState          rpkState;
 #endif /* HAVE_RPK */
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CERT_COMPRESSION)
+    byte              certCompPeer;       /* peer takes our
+                                           * CompressedCertificate */
+#endif
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CACHED_INFO)
+    byte              cachedInfoCert;     /* server Certificate carries
+                                           * only the hash of the cert */
+#endif
 
     /* need full byte values for this section */
     byte            processReply;           /* nonblocking resume */
@@ -5510,39 +5540,20 @@ typedef struct DtlsRecordLayerHeader {
     byte            length[2];
 } DtlsRecordLayerHeader;
 
-typedef struct DtlsFragBucket {
-    /* m stands for meta */
-    union {
-        struct {
-            struct DtlsFragBucket* next;
-            word32 offset;
-            word32 sz;
-        } m;
-        /* Make sure we have at least DTLS_HANDSHAKE_HEADER_SZ bytes before the
-         * buf so that we can reconstruct the header in the allocated
-         * DtlsFragBucket buffer. */
-        byte padding[DTLS_HANDSHAKE_HEADER_SZ];
-    } m;
-/* Ignore "nonstandard extension used : zero-sized array in struct/union"
- * MSVC warning */
-#ifdef _MSC_VER
-#pragma warning(disable: 4200)
-#endif
-    byte buf[];
-} DtlsFragBucket;
-
 typedef struct DtlsMsg {
     struct DtlsMsg* next;
-    byte*           raw;
+    byte*           raw;       /* header and message, after the DtlsMsg in
+                                * the same allocation */
     byte*           fullMsg;   /* for TX fullMsg == raw. For RX this points to
                                 * the start of the message after headers. */
-    DtlsFragBucket* fragBucketList;
+    word32        (*rxRanges)[2]; /* RX: received [start, end) byte ranges,
+                                   * sorted and disjoint */
     word32          bytesReceived;
     word16          epoch;     /* Epoch that this message belongs to */
     word32          seq;       /* Handshake sequence number    */
     word32          sz;        /* Length of whole message      */
     byte            type;
-    byte            fragBucketListCount;
+    byte            rxRangeCnt;
     byte            ready:1;
     byte            encrypted:1;
 } DtlsMsg;
@@ -5745,10 +5756,10 @@ enum Dtls13RtxFsmState {
 
 typedef struct Dtls13RtxRecord {
     struct Dtls13RtxRecord *next;
-    word16 length;
-    byte *data;
+    byte *data;                 /* follows the record in the same allocation */
     w64wrapper epoch;
     w64wrapper seq[DTLS13_RETRANS_RN_SIZE];
+    word16 length;
     byte rnIdx;
     byte handshakeType;
 } Dtls13RtxRecord;
@@ -5771,6 +5782,12 @@ typedef struct Dtls13Rtx {
     byte triggeredRtxs; /* Unused? */
     byte sendAcks;
     byte retransmit;
+#ifdef WOLFSSL_DTLS13_RTX_STATS
+    word32 timeoutCount;   /* long timeouts that resent the flight */
+    word32 rtxRecordCount; /* records sent again */
+    word32 rtxByteCount;   /* handshake bytes sent again */
+    word32 ackedCount;     /* records the peer acknowledged */
+#endif /* WOLFSSL_DTLS13_RTX_STATS */
 } Dtls13Rtx;
 
 #endif /* WOLFSSL_DTLS13 */
@@ -6052,6 +6069,10 @@ struct WOLFSSL {
     byte dtls13SendingFragments:1;
     byte dtls13SendingAckOrRtx;
     byte dtls13FastTimeout:1;
+    word16 dtls13AckDelay;      /* ms ACKs are held to coalesce, 0 = none */
+    word16 dtls13WriteDelay;    /* ms small writes are held, 0 = none */
+    word16 dtls13HeldWritesSz;  /* size of dtls13HeldWrites.buffer */
+    buffer dtls13HeldWrites;    /* writes held to go out as one record */
     byte dtls13WaitKeyUpdateAck;
     byte dtls13DoKeyUpdate;
     word32 dtls13MessageLength;
@@ -6468,6 +6489,7 @@ enum HandShakeType {
     finished             =  20,
     certificate_status   =  22,
     key_update           =  24,
+    compressed_certificate = 25,   /* RFC 8879 */
     change_cipher_hs     =  55,    /* simulate unique handshake type for sanity
                                       checks.  record layer change_cipher
                                       conflicts with handshake finished */
@@ -6588,6 +6610,11 @@ WOLFSSL_LOCAL int VerifyClientSuite(word16 havePSK, byte cipherSuite0,
 WOLFSSL_LOCAL int SetTicket(WOLFSSL* ssl, const byte* ticket, word32 length);
 WOLFSSL_LOCAL int wolfSSL_GetMaxFragSize(WOLFSSL* ssl, int maxFragment);
 
+#ifdef HAVE_RPK
+WOLFSSL_LOCAL int RpkPinFind(const WOLFSSL_CTX* ctx, const byte* hash,
+                             word32* pos);
+#endif
+
 #if defined(WOLFSSL_IOTSAFE) && defined(HAVE_PK_CALLBACKS)
 WOLFSSL_LOCAL IOTSAFE *wolfSSL_get_iotsafe_ctx(WOLFSSL *ssl);
 WOLFSSL_LOCAL int wolfSSL_set_iotsafe_ctx(WOLFSSL *ssl, IOTSAFE *iotsafe);
@@ -6776,7 +6803,6 @@ WOLFSSL_LOCAL word32 MacSize(const WOLFSSL* ssl);
     WOLFSSL_LOCAL int  VerifyForTxDtlsMsgDelete(WOLFSSL* ssl, DtlsMsg* item);
     WOLFSSL_LOCAL void DtlsMsgPoolReset(WOLFSSL* ssl);
     WOLFSSL_LOCAL int  DtlsMsgPoolSend(WOLFSSL* ssl, int sendOnlyFirstPacket);
-    WOLFSSL_LOCAL void DtlsMsgDestroyFragBucket(DtlsFragBucket* fragBucket, void* heap);
     WOLFSSL_LOCAL int GetDtlsHandShakeHeader(WOLFSSL *ssl, const byte *input,
         word32 *inOutIdx, byte *type, word32 *size, word32 *fragOffset,
         word32 *fragSz, word32 totalSz);
@@ -7049,14 +7075,17 @@ WOLFSSL_LOCAL int Dtls13AddHeaders(byte* output, word32 length,
 WOLFSSL_LOCAL word16 Dtls13GetHeadersLength(WOLFSSL *ssl,
     enum HandShakeType type);
 WOLFSSL_LOCAL word16 Dtls13GetRlHeaderLength(WOLFSSL *ssl, byte is_encrypted);
+WOLFSSL_LOCAL word16 Dtls13GetAppDataHeaderLength(WOLFSSL* ssl);
 WOLFSSL_LOCAL int Dtls13RlAddCiphertextHeader(WOLFSSL* ssl, byte* out,
-    word16 length);
+    word16 length, word16 headerLength);
 WOLFSSL_LOCAL int Dtls13RlAddPlaintextHeader(WOLFSSL* ssl, byte* out,
     enum ContentType content_type, word16 length);
-WOLFSSL_LOCAL int Dtls13MinimumRecordLength(WOLFSSL* ssl);
+WOLFSSL_LOCAL int Dtls13MinimumRecordLength(word16 headerLength);
 WOLFSSL_LOCAL int Dtls13EncryptRecordNumber(WOLFSSL* ssl, byte* hdr,
     word16 recordLength);
 WOLFSSL_LOCAL int Dtls13IsUnifiedHeader(byte header_flags);
+WOLFSSL_LOCAL word32 Dtls13DatagramLength(WOLFSSL* ssl, const byte* buf,
+    word32 length);
 WOLFSSL_LOCAL int Dtls13GetUnifiedHeaderSize(WOLFSSL* ssl, const byte input,
     word16* size);
 WOLFSSL_LOCAL int Dtls13ParseUnifiedRecordLayer(WOLFSSL* ssl, const byte* input,
@@ -7093,6 +7122,8 @@ WOLFSSL_LOCAL void Dtls13FreeFsmResources(WOLFSSL* ssl);
 WOLFSSL_LOCAL void Dtls13RtxFlushBuffered(WOLFSSL* ssl,
         byte keepNewSessionTicket);
 WOLFSSL_LOCAL int Dtls13RtxTimeout(WOLFSSL* ssl);
+WOLFSSL_LOCAL int Dtls13HoldWrite(WOLFSSL* ssl, const byte* data, word32 sz);
+WOLFSSL_LOCAL int Dtls13FlushWrites(WOLFSSL* ssl);
 WOLFSSL_LOCAL int Dtls13ProcessBufferedMessages(WOLFSSL* ssl);
 WOLFSSL_LOCAL int Dtls13CheckAEADFailLimit(WOLFSSL* ssl);
 WOLFSSL_LOCAL int Dtls13UpdateWindowRecordRecvd(WOLFSSL* ssl);
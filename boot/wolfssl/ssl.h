@@ -1747,6 +1747,19 @@ WOLFSSL_API int  wolfSSL_dtls_get_using_nonblock(WOLFSSL* ssl);
 WOLFSSL_API int  wolfSSL_dtls_get_current_timeout(WOLFSSL* ssl);
 WOLFSSL_API int wolfSSL_dtls13_use_quick_timeout(WOLFSSL* ssl);
 WOLFSSL_API void wolfSSL_dtls13_set_send_more_acks(WOLFSSL* ssl, int value);
+WOLFSSL_API int  wolfSSL_dtls13_set_ack_delay(WOLFSSL* ssl, int ms);
+WOLFSSL_API int  wolfSSL_dtls13_get_ack_delay(WOLFSSL* ssl);
+#ifdef WOLFSSL_DTLS13
+    /* Applications built against other wolfSSL trees test for this. */
+    #define WOLFSSL_HAVE_DTLS13_ACK_DELAY
+#endif
+WOLFSSL_API int  wolfSSL_dtls13_set_write_delay(WOLFSSL* ssl, int ms);
+WOLFSSL_API int  wolfSSL_dtls13_get_write_delay(WOLFSSL* ssl);
+WOLFSSL_API void wolfSSL_dtls13_set_short_header(WOLFSSL* ssl, int value);
+#ifdef WOLFSSL_DTLS13
+    #define WOLFSSL_HAVE_DTLS13_WRITE_DELAY
+    #define WOLFSSL_HAVE_DTLS13_SHORT_HEADER
+#endif
 WOLFSSL_API int  wolfSSL_DTLSv1_get_timeout(WOLFSSL* ssl,
         WOLFSSL_TIMEVAL* timeleft);
 WOLFSSL_API void wolfSSL_DTLSv1_set_initial_timeout_duration(WOLFSSL* ssl,
@@ -1823,6 +1836,8 @@ WOLFSSL_API int wolfSSL_export_dtls_srtp_keying_material(WOLFSSL* ssl,
 
 WOLFSSL_API int  wolfSSL_dtls_get_drop_stats(WOLFSSL* ssl,
                                              unsigned int*, unsigned int*);
+WOLFSSL_API int  wolfSSL_dtls13_get_rtx_stats(WOLFSSL* ssl, unsigned int*,
+                                unsigned int*, unsigned int*, unsigned int*);
 WOLFSSL_API int  wolfSSL_CTX_mcast_set_member_id(WOLFSSL_CTX* ctx, unsigned short id);
 WOLFSSL_API int  wolfSSL_set_secret(WOLFSSL* ssl, unsigned short epoch,
                      const unsigned char* preMasterSecret, unsigned int preMasterSz,
@@ -4701,6 +4716,12 @@ WOLFSSL_API int wolfSSL_CTX_UseSupportedCurve(WOLFSSL_CTX* ctx,
 
 #ifdef WOLFSSL_TLS13
 WOLFSSL_API int wolfSSL_UseKeyShare(WOLFSSL* ssl, word16 group);
+WOLFSSL_API int wolfSSL_UseSessionKeyShare(WOLFSSL* ssl,
+                                           WOLFSSL_SESSION* session);
+#ifdef HAVE_SUPPORTED_CURVES
+    /* Applications built against other wolfSSL trees test for this. */
+    #define WOLFSSL_HAVE_SESSION_KEY_SHARE
+#endif
 WOLFSSL_API int wolfSSL_NoKeyShares(WOLFSSL* ssl);
 #endif
 
@@ -4715,6 +4736,16 @@ WOLFSSL_API int wolfSSL_CTX_UseCKS(WOLFSSL_CTX* ctx, byte *sigSpec,
                                    word16 sigSpecSz);
 #endif /* WOLFSSL_DUAL_ALG_CERTS */
 
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CERT_COMPRESSION)
+WOLFSSL_API int wolfSSL_CTX_set_cert_compress_dict(WOLFSSL_CTX* ctx,
+                                    const unsigned char* dict, word32 dictSz);
+#endif
+
+#if defined(WOLFSSL_TLS13) && defined(HAVE_CACHED_INFO)
+WOLFSSL_API int wolfSSL_CTX_UseCachedCert(WOLFSSL_CTX* ctx,
+                                    const unsigned char* der, word32 derSz);
+#endif
+
 /* Secure Renegotiation */
 #if defined(HAVE_SECURE_RENEGOTIATION) || defined(HAVE_SERVER_RENEGOTIATION_INFO)
 
@@ -5977,6 +6008,10 @@ WOLFSSL_API int wolfSSL_set_server_cert_type(WOLFSSL* ssl,
                                           const char* buf, int len);
 WOLFSSL_API int wolfSSL_get_negotiated_client_cert_type(WOLFSSL* ssl, int* tp);
 WOLFSSL_API int wolfSSL_get_negotiated_server_cert_type(WOLFSSL* ssl, int* tp);
+WOLFSSL_API int wolfSSL_CTX_add_rpk_pin(WOLFSSL_CTX* ctx,
+                                    const unsigned char* spki, int spkiSz);
+/* Applications built against other wolfSSL trees test for this. */
+#define WOLFSSL_HAVE_RPK_PIN
 #endif /* HAVE_RPK */
 
 
@@ -36,6 +36,7 @@
 #define HAVE_ED25519         // Enable ED25519
 #define HAVE_RSA             // Enable RSA
 #define HAVE_AESGCM          // Enable AES-GCM
+#define HAVE_AESCCM          // Enable AES-CCM, for the 8-byte tags of CCM-8
 #define WC_RSA_BLINDING      // Enable RSA blinding
 #define ECC_TIMING_RESISTANT // Make ECC resistant to timing attacks
 
@@ -50,7 +51,11 @@
 #define WOLFSSL_DTLS
 #define WOLFSSL_DTLS13
 #define WOLFSSL_DTLS_CH_FRAG
+#define WOLFSSL_DTLS13_RTX_STATS // retransmission counters, printed after the handshake
 #define WOLFSSL_SEND_HRR_COOKIE
+#define HAVE_CERT_COMPRESSION // RFC 8879, CA cert as the preset dictionary
+#define HAVE_CACHED_INFO      // RFC 7924, server cert is held in firmware
+// #define HAVE_RPK           // RFC 7250 raw public keys, server on auth = rpk
 #define HAVE_TLS_EXTENSIONS
 #define HAVE_SUPPORTED_CURVES
 #define HAVE_HKDF
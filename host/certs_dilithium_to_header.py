@@ -33,6 +33,9 @@ def main():
         ("ca-cert.der", "ca_cert_dilithium_der"),
         ("client-cert.der", "client_cert_dilithium_der"),
         ("client-key.der", "client_key_dilithium_der"),
+        ("server-cert.der", "server_cert_dilithium_der"),
+        ("client-rpk.der", "client_rpk_dilithium_der"),
+        ("server-rpk.der", "server_rpk_dilithium_der"),
     ]
     
     header_content = """/* Auto-generated Dilithium certificate data for embedded DTLS client */
@@ -0,0 +1,1067 @@
+/*
+ * Fleet load generator for the host DTLS 1.3 servers.
+ *
+ * Simulates many devices with the same TLS configuration as boot/main.c:
+ * the firmware's embedded CA, client certificate and key
+ * (boot/wolfssl/certs_dilithium_data.h), mutual authentication,
+ * TLS13-AES128-GCM-SHA256, MTU 1200 and an ML-KEM key share. Each client
+ * owns a UDP socket, handshakes, echoes -n messages of -s bytes, sends
+ * close_notify and reconnects from a fresh port. Clients are spread over
+ * -t threads, each running its own epoll loop.
+ *
+ * -l and -r inject datagram loss and adjacent-datagram reordering in both
+ * directions, so the servers' retransmission and reassembly paths get
+ * exercised the way a lossy field network would.
+ *
+ * Like the firmware, clients offer and send certificates compressed against
+ * the CA (RFC 8879) when wolfSSL has HAVE_CERT_COMPRESSION, and announce the
+ * server certificate they hold (RFC 7924 cached_info) when it has
+ * HAVE_CACHED_INFO. -Z and -X turn those off so the bytes on the wire can be
+ * compared. -P authenticates with raw public keys instead (RFC 7250, the
+ * firmware built with HAVE_RPK): the device key goes out as a bare
+ * SubjectPublicKeyInfo and the server key is pinned, no CA involved.
+ *
+ * -A holds ACKs for that many milliseconds (wolfSSL_dtls13_set_ack_delay,
+ * the wolfSSL in boot/src) so the records that arrive meanwhile share one
+ * ACK, as the firmware does.
+ * Like the firmware, clients group each flight into as few MTU sized
+ * datagrams as it fits in; -G sends every record in its own datagram.
+ * They also offer TLS13-AES128-CCM-8-SHA256 ahead of AES-GCM (the server's
+ * cipher list decides) and send application data with the short unified
+ * header when wolfSSL has it (the one in boot/src); -S sends the full 16-bit
+ * sequence number and length instead. -w splits each echo into that many
+ * writes, and -W holds writes up to that many milliseconds
+ * (wolfSSL_dtls13_set_write_delay) so they share one record.
+ *
+ * Reports handshakes/s, handshake latency percentiles, echo round-trip
+ * percentiles, application-data throughput, datagrams/s and wire bytes, and
+ * the clients' DTLS 1.3 retransmission counters when wolfSSL keeps them
+ * (WOLFSSL_DTLS13_RTX_STATS).
+ *
+ * -H replaces the devices with a cookie flood: every client socket keeps
+ * resending the same captured cookie-less ClientHello and only counts the
+ * HelloRetryRequests that come back, which measures the server's stateless
+ * cookie stage on its own (the first line of defence against spoofed
+ * handshake floods).
+ */
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <wolfssl/options.h>
+#include <wolfssl/ssl.h>
+#include <wolfssl/error-ssl.h>
+
+#include "../boot/wolfssl/certs_dilithium_data.h"
+
+#define DEFAULT_SERVER_IP   "127.0.0.1"
+#define DEFAULT_SERVER_PORT 6000
+#define DTLS_MTU            1200
+
+#define BENCH_MAX_THREADS   64
+#define BENCH_MAX_PAYLOAD   1024   /* keeps one record per 1200-byte datagram */
+#define BENCH_DGRAM_MAX     2048
+#define BENCH_HOLD_MS       20     /* longest a reordered datagram is held */
+#define BENCH_FLOOD_TMO_MS  100    /* -H: resend after this long without a reply */
+
+typedef struct {
+    const char* name;
+    int group;                     /* 0 = wolfSSL default key share */
+} bench_group_t;
+
+static const bench_group_t g_groups[] = {
+#if defined(HAVE_PQC) && !defined(WOLFSSL_NO_ML_KEM)
+    { "mlkem512",      WOLFSSL_ML_KEM_512 },
+    { "mlkem768",      WOLFSSL_ML_KEM_768 },
+    { "p256_mlkem512", WOLFSSL_SECP256R1MLKEM512 },
+#endif
+    { "p256",          WOLFSSL_ECC_SECP256R1 },
+    { "default",       0 },
+};
+
+/* Latency samples in microseconds, grown on demand. */
+typedef struct {
+    unsigned int* v;
+    size_t n;
+    size_t cap;
+} bench_samples_t;
+
+typedef struct bench_thread bench_thread_t;
+
+/* One held datagram per direction for reordering. */
+typedef struct {
+    int len;
+    int release;                   /* rx: overtaken, deliver on next read */
+    long long since_ms;
+    unsigned char data[BENCH_DGRAM_MAX];
+} bench_hold_t;
+
+typedef struct {
+    bench_thread_t* thread;
+    int sock;
+    WOLFSSL* ssl;
+    WOLFSSL_SESSION* session;      /* ticket from the last connection (-R) */
+    WOLFSSL_SESSION* kx_session;   /* last connection, names the server's group (-K) */
+    int got_ticket;                /* a NewSessionTicket arrived on this one */
+    int handshake_done;
+    int msgs_done;
+    long long deadline_ms;
+    long long ack_deadline_ms;     /* ACK or writes held after the handshake (-A, -W) */
+    int echo_rx;                   /* bytes of the current echo back so far */
+    long long hs_start_us;
+    long long echo_start_us;
+    bench_hold_t tx_hold;
+    bench_hold_t rx_hold;
+} bench_client_t;
+
+/* The ClientHello the -H flood replays, captured from a real client. */
+static unsigned char g_flood_ch[BENCH_DGRAM_MAX];
+static int g_flood_ch_len;
+
+struct bench_thread {
+    pthread_t tid;
+    WOLFSSL_CTX* ctx;
+    struct sockaddr_in server;
+    int group;
+    int nclients;
+    int msgs_per_conn;
+    int payload;
+    int loss_pct;
+    int reorder_pct;
+    int resume;
+    int predict;
+    int ack_delay;
+    int write_delay;
+    int writes;                    /* writes per echo */
+    int short_header;
+    unsigned int seed;
+    long long stop_ms;
+    unsigned long handshakes;
+    unsigned long resumed;
+    unsigned long failures;
+    unsigned long echoes;
+    unsigned long long app_bytes;
+    unsigned long tx;
+    unsigned long rx;
+    unsigned long long wire_bytes;
+    unsigned long app_dgrams;      /* after the handshake */
+    unsigned long long app_wire_bytes;
+    unsigned long lost;
+    unsigned long reordered;
+    unsigned long hrrs;
+    unsigned long rtx_timeouts;
+    unsigned long rtx_records;
+    unsigned long long rtx_bytes;
+    unsigned long rtx_acked;
+    bench_samples_t hs_lat;
+    bench_samples_t res_lat;
+    bench_samples_t echo_lat;
+};
+
+static long long now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000L;
+}
+
+static long long now_ms(void)
+{
+    return now_us() / 1000LL;
+}
+
+static void samples_add(bench_samples_t* s, long long us)
+{
+    if (s->n == s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 1024;
+        unsigned int* v = (unsigned int*)realloc(s->v, cap * sizeof(*v));
+        if (v == NULL)
+            return;
+        s->v = v;
+        s->cap = cap;
+    }
+    s->v[s->n++] = us > 0xffffffffLL ? 0xffffffffu : (unsigned int)us;
+}
+
+static int cmp_uint(const void* a, const void* b)
+{
+    unsigned int x = *(const unsigned int*)a, y = *(const unsigned int*)b;
+    return x < y ? -1 : x > y;
+}
+
+static double percentile_ms(const bench_samples_t* s, double p)
+{
+    if (s->n == 0)
+        return 0.0;
+    size_t i = (size_t)(p / 100.0 * (double)(s->n - 1) + 0.5);
+    return (double)s->v[i] / 1000.0;
+}
+
+static int chance(bench_thread_t* t, int pct)
+{
+    return pct > 0 && (int)(rand_r(&t->seed) % 100) < pct;
+}
+
+/* ------------------------------------------------------------------------ */
+/* I/O callbacks with loss / reorder injection                              */
+/* ------------------------------------------------------------------------ */
+
+static int bio_recv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    bench_client_t* c = (bench_client_t*)ctx;
+    bench_thread_t* t = c->thread;
+
+    for (;;) {
+        int got;
+        if (c->rx_hold.len > 0 && c->rx_hold.release) {
+            got = c->rx_hold.len < sz ? c->rx_hold.len : sz;
+            memcpy(buf, c->rx_hold.data, (size_t)got);
+            c->rx_hold.len = 0;
+            return got;
+        }
+
+        got = (int)recv(c->sock, buf, (size_t)sz, 0);
+        if (got < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+                return WOLFSSL_CBIO_ERR_GENERAL;
+            if (c->rx_hold.len > 0) {
+                /* Nothing overtook the held datagram; deliver it now. */
+                c->rx_hold.release = 1;
+                continue;
+            }
+            return WOLFSSL_CBIO_ERR_WANT_READ;
+        }
+        t->rx++;
+        t->wire_bytes += (unsigned long long)got;
+        if (c->handshake_done) {
+            t->app_dgrams++;
+            t->app_wire_bytes += (unsigned long long)got;
+        }
+        if (chance(t, t->loss_pct)) {
+            t->lost++;
+            continue;
+        }
+        if (c->rx_hold.len == 0 && got <= BENCH_DGRAM_MAX && chance(t, t->reorder_pct)) {
+            memcpy(c->rx_hold.data, buf, (size_t)got);
+            c->rx_hold.len = got;
+            c->rx_hold.release = 0;
+            t->reordered++;
+            continue;
+        }
+        /* A held datagram goes out right after the one that overtook it. */
+        if (c->rx_hold.len > 0)
+            c->rx_hold.release = 1;
+        return got;
+    }
+}
+
+static int raw_send(bench_client_t* c, const void* buf, int sz)
+{
+    int sent = (int)send(c->sock, buf, (size_t)sz, 0);
+    if (sent >= 0) {
+        c->thread->tx++;
+        c->thread->wire_bytes += (unsigned long long)sent;
+        if (c->handshake_done) {
+            c->thread->app_dgrams++;
+            c->thread->app_wire_bytes += (unsigned long long)sent;
+        }
+    }
+    return sent;
+}
+
+static int bio_send(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    bench_client_t* c = (bench_client_t*)ctx;
+    bench_thread_t* t = c->thread;
+
+    if (chance(t, t->loss_pct)) {
+        t->lost++;
+        return sz;
+    }
+    if (c->tx_hold.len == 0 && sz <= BENCH_DGRAM_MAX && chance(t, t->reorder_pct)) {
+        memcpy(c->tx_hold.data, buf, (size_t)sz);
+        c->tx_hold.len = sz;
+        c->tx_hold.since_ms = now_ms();
+        t->reordered++;
+        return sz;
+    }
+
+    int sent = raw_send(c, buf, sz);
+    if (sent < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+            return WOLFSSL_CBIO_ERR_WANT_WRITE;
+        return WOLFSSL_CBIO_ERR_GENERAL;
+    }
+    if (c->tx_hold.len > 0) {
+        raw_send(c, c->tx_hold.data, c->tx_hold.len);
+        c->tx_hold.len = 0;
+    }
+    return sent;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Client lifecycle                                                         */
+/* ------------------------------------------------------------------------ */
+
+static void client_close(int ep, bench_client_t* c)
+{
+    if (c->ssl != NULL) {
+        if (c->handshake_done && c->thread->resume) {
+            /* Without a fresh ticket the session still names the ticket this
+             * connection already spent, but carries the new secret; the
+             * server would reject its binder. */
+            WOLFSSL_SESSION* sess = c->got_ticket ? wolfSSL_get1_session(c->ssl) : NULL;
+            wolfSSL_SESSION_free(c->session);
+            c->session = sess;
+        }
+        if (c->handshake_done && c->thread->predict) {
+            wolfSSL_SESSION_free(c->kx_session);
+            c->kx_session = wolfSSL_get1_session(c->ssl);
+        }
+        if (c->handshake_done)
+            wolfSSL_shutdown(c->ssl);
+#ifdef WOLFSSL_DTLS13_RTX_STATS
+        unsigned int tmo = 0, recs = 0, bytes = 0, acked = 0;
+        if (wolfSSL_dtls13_get_rtx_stats(c->ssl, &tmo, &recs, &bytes, &acked) == WOLFSSL_SUCCESS) {
+            c->thread->rtx_timeouts += tmo;
+            c->thread->rtx_records += recs;
+            c->thread->rtx_bytes += bytes;
+            c->thread->rtx_acked += acked;
+        }
+#endif
+        wolfSSL_free(c->ssl);
+        c->ssl = NULL;
+    }
+    if (c->sock >= 0) {
+        epoll_ctl(ep, EPOLL_CTL_DEL, c->sock, NULL);
+        close(c->sock);
+        c->sock = -1;
+    }
+    c->tx_hold.len = 0;
+    c->rx_hold.len = 0;
+}
+
+static int on_ticket(WOLFSSL* ssl, const unsigned char* ticket, int len, void* ctx)
+{
+    (void)ssl;
+    (void)ticket;
+    (void)len;
+    ((bench_client_t*)ctx)->got_ticket = 1;
+    return 0;
+}
+
+/* Fresh socket (so a fresh source port) and a fresh association. */
+static int client_open(int ep, bench_client_t* c)
+{
+    bench_thread_t* t = c->thread;
+
+    c->sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (c->sock < 0)
+        return -1;
+    if (connect(c->sock, (struct sockaddr*)&t->server, sizeof(t->server)) < 0) {
+        close(c->sock);
+        c->sock = -1;
+        return -1;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = c;
+    epoll_ctl(ep, EPOLL_CTL_ADD, c->sock, &ev);
+
+    c->ssl = wolfSSL_new(t->ctx);
+    if (c->ssl == NULL) {
+        client_close(ep, c);
+        return -1;
+    }
+    wolfSSL_SetIOReadCtx(c->ssl, c);
+    wolfSSL_SetIOWriteCtx(c->ssl, c);
+    wolfSSL_dtls_set_using_nonblock(c->ssl, 1);
+    wolfSSL_dtls_set_peer(c->ssl, &t->server, sizeof(t->server));
+#ifdef WOLFSSL_HAVE_DTLS13_ACK_DELAY
+    if (t->ack_delay > 0)
+        wolfSSL_dtls13_set_ack_delay(c->ssl, t->ack_delay);
+#endif
+#ifdef WOLFSSL_HAVE_DTLS13_WRITE_DELAY
+    if (t->write_delay > 0)
+        wolfSSL_dtls13_set_write_delay(c->ssl, t->write_delay);
+#endif
+#ifdef WOLFSSL_HAVE_DTLS13_SHORT_HEADER
+    wolfSSL_dtls13_set_short_header(c->ssl, t->short_header);
+#endif
+#ifdef WOLFSSL_DTLS_MTU
+    wolfSSL_dtls_set_mtu(c->ssl, DTLS_MTU);
+#endif
+#ifdef WOLFSSL_DTLS_CID
+    wolfSSL_dtls_cid_use(c->ssl);
+#endif
+    int predicted = 0;
+#ifdef WOLFSSL_HAVE_SESSION_KEY_SHARE
+    /* -K: the group the server picked last time, so no HelloRetryRequest
+     * has to ask for it. */
+    predicted = t->predict && c->kx_session != NULL &&
+                wolfSSL_UseSessionKeyShare(c->ssl, c->kx_session) == WOLFSSL_SUCCESS;
+#endif
+    if (!predicted && t->group != 0) {
+        int group = t->group;
+        wolfSSL_set_groups(c->ssl, &group, 1);
+        wolfSSL_UseKeyShare(c->ssl, (word16)group);
+    }
+    if (t->resume) {
+        wolfSSL_set_SessionTicket_cb(c->ssl, on_ticket, c);
+        if (c->session != NULL)
+            wolfSSL_set_session(c->ssl, c->session);
+    }
+    c->got_ticket = 0;
+    c->handshake_done = 0;
+    c->msgs_done = 0;
+    c->deadline_ms = 0;
+    c->ack_deadline_ms = 0;
+    c->hs_start_us = now_us();
+    return 0;
+}
+
+static void client_arm_timer(bench_client_t* c)
+{
+    long long tmo = (long long)wolfSSL_dtls_get_current_timeout(c->ssl) * 1000LL;
+    if (wolfSSL_dtls13_use_quick_timeout(c->ssl))
+        tmo = c->thread->ack_delay > 0 ? c->thread->ack_delay : tmo / 4;
+    c->deadline_ms = now_ms() + tmo;
+}
+
+static void client_send_echo(bench_client_t* c)
+{
+    static const char pattern[] = "sensor-reading-0123456789abcdef";
+    char msg[BENCH_MAX_PAYLOAD];
+    for (int i = 0; i < c->thread->payload; i++)
+        msg[i] = pattern[i % (int)(sizeof(pattern) - 1)];
+    c->echo_start_us = now_us();
+    c->echo_rx = 0;
+    for (int i = 0; i < c->thread->writes; i++)
+        wolfSSL_write(c->ssl, msg, c->thread->payload);
+    /* Held writes go out when the write delay is over. */
+    if (c->thread->write_delay > 0 && wolfSSL_dtls13_use_quick_timeout(c->ssl))
+        c->ack_deadline_ms = now_ms() + c->thread->write_delay;
+    /* App data is not retransmitted by DTLS; time out a lost echo. */
+    c->deadline_ms = now_ms() + 1000;
+}
+
+/* Advance one client as far as the data it has allows. */
+static void client_drive(int ep, bench_client_t* c)
+{
+    bench_thread_t* t = c->thread;
+    char buf[BENCH_MAX_PAYLOAD];
+    int ret, err;
+
+    if (!c->handshake_done) {
+        ret = wolfSSL_connect(c->ssl);
+        if (ret != WOLFSSL_SUCCESS) {
+            err = wolfSSL_get_error(c->ssl, ret);
+            if (err == WOLFSSL_ERROR_WANT_READ || err == WOLFSSL_ERROR_WANT_WRITE) {
+                client_arm_timer(c);
+                return;
+            }
+            t->failures++;
+            client_close(ep, c);
+            if (now_ms() < t->stop_ms && client_open(ep, c) == 0)
+                client_drive(ep, c);
+            return;
+        }
+        c->handshake_done = 1;
+        t->handshakes++;
+        if (wolfSSL_session_reused(c->ssl)) {
+            t->resumed++;
+            samples_add(&t->res_lat, now_us() - c->hs_start_us);
+        }
+        else {
+            samples_add(&t->hs_lat, now_us() - c->hs_start_us);
+        }
+        client_send_echo(c);
+    }
+
+    for (;;) {
+        ret = wolfSSL_read(c->ssl, buf, sizeof(buf));
+        if (ret <= 0) {
+            err = wolfSSL_get_error(c->ssl, ret);
+            if (err == WOLFSSL_ERROR_WANT_READ || err == WOLFSSL_ERROR_WANT_WRITE) {
+                /* An ACK for a NewSessionTicket may be held. */
+                if (t->ack_delay > 0 && c->ack_deadline_ms == 0 &&
+                    wolfSSL_dtls13_use_quick_timeout(c->ssl))
+                    c->ack_deadline_ms = now_ms() + t->ack_delay;
+                return;
+            }
+            t->failures++;
+            break;
+        }
+        /* The server echoes each record it gets; without -W the writes of
+         * one echo come back as several. */
+        c->echo_rx += ret;
+        if (c->echo_rx < t->payload * t->writes)
+            continue;
+        t->echoes++;
+        t->app_bytes += (unsigned long long)c->echo_rx * 2u;
+        samples_add(&t->echo_lat, now_us() - c->echo_start_us);
+        if (++c->msgs_done < t->msgs_per_conn) {
+            client_send_echo(c);
+            continue;
+        }
+        break;
+    }
+
+    client_close(ep, c);
+    if (now_ms() < t->stop_ms && client_open(ep, c) == 0)
+        client_drive(ep, c);
+}
+
+/* Retransmission timers, lost echoes and held (reordered) datagrams. */
+static void client_tick(int ep, bench_client_t* c, long long now)
+{
+    bench_thread_t* t = c->thread;
+
+    if (c->tx_hold.len > 0 && now - c->tx_hold.since_ms >= BENCH_HOLD_MS) {
+        raw_send(c, c->tx_hold.data, c->tx_hold.len);
+        c->tx_hold.len = 0;
+    }
+    if (c->ssl != NULL && c->ack_deadline_ms != 0 && now >= c->ack_deadline_ms) {
+        c->ack_deadline_ms = 0;
+        wolfSSL_dtls_got_timeout(c->ssl);
+    }
+    if (c->ssl == NULL || c->deadline_ms == 0 || now < c->deadline_ms)
+        return;
+
+    if (c->handshake_done) {
+        /* Echo or its reply was lost; send the next one. */
+        if (++c->msgs_done < t->msgs_per_conn) {
+            client_send_echo(c);
+            return;
+        }
+        client_close(ep, c);
+    }
+    else if (wolfSSL_dtls_got_timeout(c->ssl) != WOLFSSL_FATAL_ERROR) {
+        client_arm_timer(c);
+        return;
+    }
+    else {
+        t->failures++;
+        client_close(ep, c);
+    }
+    if (now < t->stop_ms && client_open(ep, c) == 0)
+        client_drive(ep, c);
+}
+
+static void* bench_thread(void* arg)
+{
+    bench_thread_t* t = (bench_thread_t*)arg;
+    bench_client_t* clients = (bench_client_t*)calloc((size_t)t->nclients, sizeof(*clients));
+    int ep = epoll_create1(0);
+    if (clients == NULL || ep < 0) {
+        free(clients);
+        return NULL;
+    }
+
+    for (int i = 0; i < t->nclients; i++) {
+        clients[i].thread = t;
+        clients[i].sock = -1;
+        if (client_open(ep, &clients[i]) == 0)
+            client_drive(ep, &clients[i]);
+    }
+
+    struct epoll_event events[64];
+    while (now_ms() < t->stop_ms) {
+        int n = epoll_wait(ep, events, 64, 5);
+        for (int i = 0; i < n; i++) {
+            bench_client_t* c = (bench_client_t*)events[i].data.ptr;
+            if (c->ssl != NULL)
+                client_drive(ep, c);
+        }
+
+        long long now = now_ms();
+        for (int i = 0; i < t->nclients; i++)
+            client_tick(ep, &clients[i], now);
+    }
+
+    for (int i = 0; i < t->nclients; i++) {
+        client_close(ep, &clients[i]);
+        wolfSSL_SESSION_free(clients[i].session);
+        wolfSSL_SESSION_free(clients[i].kx_session);
+    }
+    close(ep);
+    free(clients);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Cookie flood (-H)                                                        */
+/* ------------------------------------------------------------------------ */
+
+static int capture_send(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)ctx;
+    if (g_flood_ch_len == 0 && sz <= (int)sizeof(g_flood_ch)) {
+        memcpy(g_flood_ch, buf, (size_t)sz);
+        g_flood_ch_len = sz;
+    }
+    return sz;
+}
+
+/* Run a client up to its first flight and keep the datagram it sends. */
+static int flood_capture(WOLFSSL_CTX* ctx, int group)
+{
+    WOLFSSL* ssl = wolfSSL_new(ctx);
+    if (ssl == NULL)
+        return -1;
+    wolfSSL_SSLSetIOSend(ssl, capture_send);
+    wolfSSL_dtls_set_using_nonblock(ssl, 1);
+#ifdef WOLFSSL_DTLS_MTU
+    wolfSSL_dtls_set_mtu(ssl, DTLS_MTU);
+#endif
+    if (group != 0) {
+        wolfSSL_set_groups(ssl, &group, 1);
+        wolfSSL_UseKeyShare(ssl, (word16)group);
+    }
+    wolfSSL_connect(ssl);
+    wolfSSL_free(ssl);
+    return g_flood_ch_len > 0 ? 0 : -1;
+}
+
+/* A plaintext ServerHello carrying the HelloRetryRequest random. */
+static int is_hrr(const unsigned char* d, int len)
+{
+    static const unsigned char hrr_random[4] = { 0xcf, 0x21, 0xad, 0x74 };
+    return len >= 13 + 12 + 2 + 4 && d[0] == 22 && d[13] == 2 &&
+           memcmp(d + 13 + 12 + 2, hrr_random, sizeof(hrr_random)) == 0;
+}
+
+/* Each socket is its own source port, so every reply carries a cookie
+ * bound to a different peer. One ClientHello in flight per socket. */
+static void* flood_thread(void* arg)
+{
+    bench_thread_t* t = (bench_thread_t*)arg;
+    int* socks = (int*)malloc((size_t)t->nclients * sizeof(*socks));
+    long long* sent_ms = (long long*)calloc((size_t)t->nclients, sizeof(*sent_ms));
+    int ep = epoll_create1(0);
+    if (socks == NULL || sent_ms == NULL || ep < 0) {
+        free(socks);
+        free(sent_ms);
+        return NULL;
+    }
+
+    for (int i = 0; i < t->nclients; i++) {
+        socks[i] = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        if (socks[i] < 0 ||
+            connect(socks[i], (struct sockaddr*)&t->server, sizeof(t->server)) < 0)
+            continue;
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)i;
+        epoll_ctl(ep, EPOLL_CTL_ADD, socks[i], &ev);
+        if (send(socks[i], g_flood_ch, (size_t)g_flood_ch_len, 0) >= 0)
+            t->tx++;
+        sent_ms[i] = now_ms();
+    }
+
+    struct epoll_event events[64];
+    unsigned char buf[BENCH_DGRAM_MAX];
+    while (now_ms() < t->stop_ms) {
+        int n = epoll_wait(ep, events, 64, 5);
+        long long now = now_ms();
+        for (int i = 0; i < n; i++) {
+            int k = (int)events[i].data.u32;
+            int got;
+            while ((got = (int)recv(socks[k], buf, sizeof(buf), 0)) > 0) {
+                t->rx++;
+                if (is_hrr(buf, got))
+                    t->hrrs++;
+            }
+            if (send(socks[k], g_flood_ch, (size_t)g_flood_ch_len, 0) >= 0)
+                t->tx++;
+            sent_ms[k] = now;
+        }
+        for (int i = 0; i < t->nclients; i++) {
+            if (socks[i] >= 0 && now - sent_ms[i] >= BENCH_FLOOD_TMO_MS) {
+                t->failures++;
+                if (send(socks[i], g_flood_ch, (size_t)g_flood_ch_len, 0) >= 0)
+                    t->tx++;
+                sent_ms[i] = now;
+            }
+        }
+    }
+
+    for (int i = 0; i < t->nclients; i++) {
+        if (socks[i] >= 0)
+            close(socks[i]);
+    }
+    close(ep);
+    free(socks);
+    free(sent_ms);
+    return NULL;
+}
+
+/* Accept certificates even if the host clock is outside their validity,
+ * exactly like the firmware (it has no RTC). */
+static int verify_allow_badtime(int preverify, WOLFSSL_X509_STORE_CTX* store)
+{
+    int err = wolfSSL_X509_STORE_CTX_get_error(store);
+    if (err == ASN_BEFORE_DATE_E || err == ASN_AFTER_DATE_E)
+        return 1;
+    return preverify;
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [options] [server_ip] [port]\n"
+                    "  -c N     concurrent simulated devices (default 64)\n"
+                    "  -t N     client threads (default 4, max %d)\n"
+                    "  -d N     run time in seconds (default 10)\n"
+                    "  -n N     echoed messages per connection before reconnecting (default 10)\n"
+                    "  -s N     app-data payload bytes (default 32, max %d)\n"
+                    "  -k NAME  key share group:",
+            prog, BENCH_MAX_THREADS, BENCH_MAX_PAYLOAD);
+    for (size_t i = 0; i < sizeof(g_groups) / sizeof(g_groups[0]); i++)
+        fprintf(stderr, " %s%s", g_groups[i].name, i == 0 ? " (default)" : "");
+    fprintf(stderr, "\n"
+                    "  -l PCT   drop PCT%% of datagrams in each direction\n"
+                    "  -r PCT   reorder PCT%% of datagrams in each direction\n"
+                    "  -R       reconnect with the last session ticket (resumption)\n"
+                    "  -K       reconnect with a key share for the group the server chose last\n"
+                    "  -H       cookie flood: replay one ClientHello, count HelloRetryRequests\n"
+                    "  -Z       no certificate compression (the firmware compresses against its CA)\n"
+                    "  -X       no cached server certificate (the firmware holds it)\n"
+                    "  -P       raw public keys against a server on auth = rpk (implies -Z -X)\n"
+                    "  -A MS    hold ACKs up to MS ms to coalesce them (default 0, send at once)\n"
+                    "  -G       one datagram per record (the firmware groups each flight)\n"
+                    "  -S       full app-data record headers (the firmware sends short ones)\n"
+                    "  -w N     writes per echo, each of -s bytes (default 1)\n"
+                    "  -W MS    hold writes up to MS ms to share one record (default 0, send at once)\n");
+}
+
+int main(int argc, char** argv)
+{
+    int nclients = 64;
+    int nthreads = 4;
+    int seconds = 10;
+    int msgs = 10;
+    int payload = 32;
+    int loss = 0;
+    int reorder = 0;
+    int resume = 0;
+    int predict = 0;
+    int flood = 0;
+    int compress = 1;
+    int cached = 1;
+    int rpk = 0;
+    int ack_delay = 0;
+    int grouped = 1;
+    int short_header = 1;
+    int writes = 1;
+    int write_delay = 0;
+    const bench_group_t* group = &g_groups[0];
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:t:d:n:s:k:l:r:A:w:W:RKHZXPGSh")) != -1) {
+        switch (opt) {
+        case 'c': nclients = atoi(optarg); break;
+        case 't': nthreads = atoi(optarg); break;
+        case 'd': seconds = atoi(optarg); break;
+        case 'n': msgs = atoi(optarg); break;
+        case 's': payload = atoi(optarg); break;
+        case 'l': loss = atoi(optarg); break;
+        case 'r': reorder = atoi(optarg); break;
+        case 'A': ack_delay = atoi(optarg); break;
+        case 'R': resume = 1; break;
+        case 'K': predict = 1; break;
+        case 'H': flood = 1; break;
+        case 'Z': compress = 0; break;
+        case 'X': cached = 0; break;
+        case 'P': rpk = 1; break;
+        case 'G': grouped = 0; break;
+        case 'S': short_header = 0; break;
+        case 'w': writes = atoi(optarg); break;
+        case 'W': write_delay = atoi(optarg); break;
+        case 'k':
+            group = NULL;
+            for (size_t i = 0; i < sizeof(g_groups) / sizeof(g_groups[0]); i++) {
+                if (strcmp(optarg, g_groups[i].name) == 0)
+                    group = &g_groups[i];
+            }
+            if (group == NULL) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (nclients < 1 || nthreads < 1 || nthreads > BENCH_MAX_THREADS ||
+        seconds < 1 || msgs < 1 || payload < 1 || payload > BENCH_MAX_PAYLOAD ||
+        loss < 0 || loss > 100 || reorder < 0 || reorder > 100 ||
+        ack_delay < 0 || ack_delay > 0xFFFF || writes < 1 ||
+        payload * writes > BENCH_MAX_PAYLOAD || write_delay < 0 || write_delay > 0xFFFF) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (nthreads > nclients)
+        nthreads = nclients;
+
+    struct sockaddr_in server;
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_port = htons((uint16_t)(optind + 1 < argc ? atoi(argv[optind + 1]) : DEFAULT_SERVER_PORT));
+    if (inet_aton(optind < argc ? argv[optind] : DEFAULT_SERVER_IP, &server.sin_addr) == 0) {
+        fprintf(stderr, "Invalid server IP\n");
+        return 1;
+    }
+
+    /* One socket per simulated device. */
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+#ifndef WOLFSSL_HAVE_DTLS13_ACK_DELAY
+    if (ack_delay > 0) {
+        fprintf(stderr, "[Init] ✗ -A needs the wolfSSL from boot/src (wolfSSL_dtls13_set_ack_delay)\n");
+        return 1;
+    }
+#endif
+#ifndef WOLFSSL_HAVE_SESSION_KEY_SHARE
+    if (predict) {
+        fprintf(stderr, "[Init] ✗ -K needs the wolfSSL from boot/src (wolfSSL_UseSessionKeyShare)\n");
+        return 1;
+    }
+#endif
+#ifndef WOLFSSL_HAVE_DTLS13_WRITE_DELAY
+    if (write_delay > 0) {
+        fprintf(stderr, "[Init] ✗ -W needs the wolfSSL from boot/src (wolfSSL_dtls13_set_write_delay)\n");
+        return 1;
+    }
+#endif
+#ifndef WOLFSSL_HAVE_DTLS13_SHORT_HEADER
+    short_header = 0;
+#endif
+
+    wolfSSL_Init();
+    WOLFSSL_CTX* ctx = wolfSSL_CTX_new(wolfDTLSv1_3_client_method());
+    if (rpk) {
+#ifdef WOLFSSL_HAVE_RPK_PIN
+        static const char rpk_only[] = { WOLFSSL_CERT_TYPE_RPK };
+        if (ctx == NULL ||
+            wolfSSL_CTX_set_client_cert_type(ctx, rpk_only, 1) != WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_set_server_cert_type(ctx, rpk_only, 1) != WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_use_certificate_buffer(ctx, client_rpk_dilithium_der, client_rpk_dilithium_der_len,
+                                               WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_use_PrivateKey_buffer(ctx, client_key_dilithium_der, client_key_dilithium_der_len,
+                                              WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_add_rpk_pin(ctx, server_rpk_dilithium_der, (int)server_rpk_dilithium_der_len)
+                != WOLFSSL_SUCCESS) {
+            fprintf(stderr, "[Init] ✗ Failed to load the firmware's raw public keys\n");
+            return 1;
+        }
+        compress = 0;
+        cached = 0;
+#else
+        fprintf(stderr, "[Init] ✗ -P needs the wolfSSL from boot/src (wolfSSL_CTX_add_rpk_pin)\n");
+        return 1;
+#endif
+    }
+    else if (ctx == NULL ||
+        wolfSSL_CTX_load_verify_buffer(ctx, ca_cert_dilithium_der, ca_cert_dilithium_der_len,
+                                       WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_use_certificate_buffer(ctx, client_cert_dilithium_der, client_cert_dilithium_der_len,
+                                           WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_use_PrivateKey_buffer(ctx, client_key_dilithium_der, client_key_dilithium_der_len,
+                                          WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Failed to load the firmware's embedded credentials\n");
+        return 1;
+    }
+#ifdef HAVE_CERT_COMPRESSION
+    if (compress &&
+        wolfSSL_CTX_set_cert_compress_dict(ctx, ca_cert_dilithium_der, ca_cert_dilithium_der_len)
+            != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Certificate compression dictionary rejected\n");
+        return 1;
+    }
+#else
+    compress = 0;
+#endif
+#ifdef HAVE_CACHED_INFO
+    if (cached &&
+        (wolfSSL_CTX_UseCachedCert(ctx, server_cert_dilithium_der, server_cert_dilithium_der_len)
+            != WOLFSSL_SUCCESS
+    #ifdef WOLFSSL_TRUST_PEER_CERT
+         || wolfSSL_CTX_trust_peer_buffer(ctx, server_cert_dilithium_der,
+                                          server_cert_dilithium_der_len, WOLFSSL_FILETYPE_ASN1)
+            != WOLFSSL_SUCCESS
+    #endif
+         )) {
+        fprintf(stderr, "[Init] ✗ Cached server certificate rejected\n");
+        return 1;
+    }
+#else
+    cached = 0;
+#endif
+    wolfSSL_CTX_set_verify(ctx, WOLFSSL_VERIFY_PEER | WOLFSSL_VERIFY_FAIL_IF_NO_PEER_CERT,
+                           verify_allow_badtime);
+    wolfSSL_CTX_set_cipher_list(ctx, "TLS13-AES128-CCM-8-SHA256:TLS13-AES128-GCM-SHA256");
+    wolfSSL_CTX_set_options(ctx, WOLFSSL_OP_NO_QUERY_MTU);
+    if (grouped)
+        wolfSSL_CTX_set_group_messages(ctx);
+    wolfSSL_SetIORecv(ctx, bio_recv);
+    wolfSSL_SetIOSend(ctx, bio_send);
+
+    printf("=== DTLS 1.3 Fleet Load Generator ===\n");
+    if (flood) {
+        if (flood_capture(ctx, group->group) != 0) {
+            fprintf(stderr, "[Init] ✗ Failed to capture a ClientHello\n");
+            return 1;
+        }
+        printf("cookie flood: %d sockets on %d threads, %d s, %d-byte ClientHello, key share %s\n",
+               nclients, nthreads, seconds, g_flood_ch_len, group->name);
+    }
+    else {
+        printf("%d clients on %d threads, %d s, %d x %d-byte echoes per connection",
+               nclients, nthreads, seconds, msgs, payload * writes);
+        if (writes > 1)
+            printf(" in %d writes", writes);
+        printf("\n");
+        printf("key share %s%s, loss %d%%, reorder %d%%%s%s%s%s\n", group->name,
+               predict ? " then predicted from the last session" : "", loss, reorder,
+               resume ? ", resuming with tickets" : "",
+               rpk ? ", raw public keys" : "",
+               compress ? ", certificates compressed against the CA" : "",
+               cached ? ", server certificate cached" : "");
+        if (ack_delay > 0)
+            printf("ACKs held up to %d ms\n", ack_delay);
+        if (!grouped)
+            printf("one datagram per record\n");
+        if (!short_header)
+            printf("full app-data record headers\n");
+        if (write_delay > 0)
+            printf("writes held up to %d ms\n", write_delay);
+    }
+
+    static bench_thread_t threads[BENCH_MAX_THREADS];
+    long long start = now_ms();
+    for (int i = 0; i < nthreads; i++) {
+        bench_thread_t* t = &threads[i];
+        t->ctx = ctx;
+        t->server = server;
+        t->group = group->group;
+        t->nclients = nclients / nthreads + (i < nclients % nthreads ? 1 : 0);
+        t->msgs_per_conn = msgs;
+        t->payload = payload;
+        t->loss_pct = loss;
+        t->reorder_pct = reorder;
+        t->resume = resume;
+        t->predict = predict;
+        t->ack_delay = ack_delay;
+        t->write_delay = write_delay;
+        t->writes = writes;
+        t->short_header = short_header;
+        t->seed = (unsigned int)(start ^ (i * 2654435761u));
+        t->stop_ms = start + seconds * 1000LL;
+        pthread_create(&t->tid, NULL, flood ? flood_thread : bench_thread, t);
+    }
+
+    unsigned long hs = 0, res = 0, fail = 0, echoes = 0, tx = 0, rx = 0, lost = 0, reord = 0;
+    unsigned long hrrs = 0, rtx_tmo = 0, rtx_recs = 0, rtx_acked = 0;
+    unsigned long long bytes = 0, wire = 0, rtx_bytes = 0, app_wire = 0;
+    unsigned long app_dgrams = 0;
+    bench_samples_t hs_lat = {0}, res_lat = {0}, echo_lat = {0};
+    for (int i = 0; i < nthreads; i++) {
+        bench_thread_t* t = &threads[i];
+        pthread_join(t->tid, NULL);
+        hs += t->handshakes;
+        res += t->resumed;
+        fail += t->failures;
+        echoes += t->echoes;
+        bytes += t->app_bytes;
+        tx += t->tx;
+        rx += t->rx;
+        wire += t->wire_bytes;
+        app_dgrams += t->app_dgrams;
+        app_wire += t->app_wire_bytes;
+        lost += t->lost;
+        reord += t->reordered;
+        hrrs += t->hrrs;
+        rtx_tmo += t->rtx_timeouts;
+        rtx_recs += t->rtx_records;
+        rtx_bytes += t->rtx_bytes;
+        rtx_acked += t->rtx_acked;
+        for (size_t j = 0; j < t->hs_lat.n; j++)
+            samples_add(&hs_lat, t->hs_lat.v[j]);
+        for (size_t j = 0; j < t->res_lat.n; j++)
+            samples_add(&res_lat, t->res_lat.v[j]);
+        for (size_t j = 0; j < t->echo_lat.n; j++)
+            samples_add(&echo_lat, t->echo_lat.v[j]);
+        free(t->hs_lat.v);
+        free(t->res_lat.v);
+        free(t->echo_lat.v);
+    }
+    double secs = (double)(now_ms() - start) / 1000.0;
+    qsort(hs_lat.v, hs_lat.n, sizeof(*hs_lat.v), cmp_uint);
+    qsort(res_lat.v, res_lat.n, sizeof(*res_lat.v), cmp_uint);
+    qsort(echo_lat.v, echo_lat.n, sizeof(*echo_lat.v), cmp_uint);
+
+    printf("\n=== Results (%.1f s) ===\n", secs);
+    if (flood) {
+        printf("cookies:     %lu HelloRetryRequests (%.1f/s), %lu other replies\n",
+               hrrs, (double)hrrs / secs, rx - hrrs);
+        printf("datagrams:   %lu tx (%.1f/s), %lu timed out\n",
+               tx, (double)tx / secs, fail);
+        wolfSSL_CTX_free(ctx);
+        wolfSSL_Cleanup();
+        return 0;
+    }
+    printf("handshakes:  %lu (%.1f/s), %lu failed\n", hs, (double)hs / secs, fail);
+    printf("  latency ms p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+           percentile_ms(&hs_lat, 50), percentile_ms(&hs_lat, 90),
+           percentile_ms(&hs_lat, 99), percentile_ms(&hs_lat, 100));
+    if (resume) {
+        printf("resumed:     %lu of %lu (%.1f%%)\n", res, hs,
+               hs ? 100.0 * (double)res / (double)hs : 0.0);
+        printf("  latency ms p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+               percentile_ms(&res_lat, 50), percentile_ms(&res_lat, 90),
+               percentile_ms(&res_lat, 99), percentile_ms(&res_lat, 100));
+    }
+    printf("echoes:      %lu (%.1f/s), %.3f MB/s app data\n",
+           echoes, (double)echoes / secs, (double)bytes / secs / 1e6);
+    printf("  rtt ms     p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+           percentile_ms(&echo_lat, 50), percentile_ms(&echo_lat, 90),
+           percentile_ms(&echo_lat, 99), percentile_ms(&echo_lat, 100));
+    printf("datagrams:   %lu tx + %lu rx (%.1f/s), %lu dropped, %lu reordered\n",
+           tx, rx, (double)(tx + rx) / secs, lost, reord);
+    printf("wire bytes:  %llu (%.0f per connection, handshake included)\n",
+           wire, hs ? (double)wire / (double)hs : 0.0);
+    printf("  after the handshake %llu in %lu datagrams (%.1f per echo)\n",
+           app_wire, app_dgrams, echoes ? (double)app_wire / (double)echoes : 0.0);
+#ifdef WOLFSSL_DTLS13_RTX_STATS
+    printf("client rtx:  %lu records (%llu bytes), %lu timeouts, %lu records ACKed\n",
+           rtx_recs, rtx_bytes, rtx_tmo, rtx_acked);
+#endif
+
+    free(hs_lat.v);
+    free(res_lat.v);
+    free(echo_lat.v);
+    wolfSSL_CTX_free(ctx);
+    wolfSSL_Cleanup();
+    return 0;
+}
@@ -0,0 +1,3281 @@
+/*
+ * DTLS 1.3 fleet server.
+ *
+ * One UDP socket serves many devices at once. Every datagram is routed to a
+ * per-peer session through two hash indices:
+ *   - by DTLS 1.3 Connection ID, when the record carries a unified header
+ *     with the C bit set (so a device that changes address/port keeps its
+ *     session), and
+ *   - by source 4-tuple otherwise.
+ * Datagrams that match no session go through a stateless cookie stage
+ * first: a cookie-less ClientHello is parsed here and answered with a
+ * HelloRetryRequest whose cookie is an HMAC (rotating key) over the
+ * ClientHello hash and the peer address, without touching any WOLFSSL
+ * object. Only a ClientHello whose cookie verifies reaches the single
+ * stateless listener object (wolfDTLS_accept_stateless), which then
+ * promotes into a real session.
+ *
+ * I/O is batched: one recvmmsg() pulls up to -m datagrams, which are staged
+ * on their sessions' receive queues; each touched session is then driven
+ * once and everything wolfSSL wrote is flushed with one sendmmsg(). -m 1
+ * falls back to one datagram per syscall.
+ *
+ * -w N runs N workers, each with its own SO_REUSEPORT socket, WOLFSSL_CTX,
+ * listener and session tables, so nothing on the datagram path is shared.
+ * The kernel spreads peers over the sockets by 4-tuple hash. The first CID
+ * byte names the owning worker; a CID record that the kernel delivered to a
+ * different worker (the device changed address) is handed to the owner
+ * through its inbox and eventfd.
+ *
+ * -c N moves handshakes off the I/O threads: wolfSSL_accept() (ML-KEM
+ * encapsulation, CertificateVerify signing, client certificate checks)
+ * runs on a pool of N crypto threads while the worker keeps routing
+ * datagrams for every other peer. Datagrams for a session in flight are
+ * copied into its backlog and handed over with the next job.
+ *
+ * Devices that come back resume from a TLS 1.3 session ticket instead of
+ * repeating the Dilithium authentication. Tickets are AES-256-GCM sealed
+ * under a small key ring shared by all workers (-T sets how often a new
+ * key takes over), so accepting one is a stateless decrypt wherever the
+ * device lands.
+ *
+ * -S NAME keeps sessions in a POSIX shared-memory table (/dev/shm/NAME)
+ * instead: tickets become bare IDs looked up through wolfSSL's external
+ * cache callbacks, so any worker, any server process on the host and a
+ * restarted server can resume them.
+ *
+ * -M PORT serves Prometheus text metrics on 127.0.0.1:PORT/metrics:
+ * datagram/byte/syscall counters, retransmissions, AEAD failures, active
+ * sessions and handshake phase histograms, per worker. Each counter has
+ * one writing thread and is read with relaxed atomics, so the datagram
+ * path takes no lock for them.
+ *
+ * Authentication (certificates, raw public keys checked against a device
+ * allow-list, or an external PSK), credentials, key
+ * exchange groups, cipher suites, MTU and the options above are runtime
+ * settings, read from -f FILE ("key = value" lines, see host/conf/) and
+ * overridden on the command line, so every deployment runs this one
+ * engine.
+ */
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/file.h>
+#include <sys/poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <wolfssl/options.h>
+#include <wolfssl/ssl.h>
+#include <wolfssl/error-ssl.h>
+#include <wolfssl/wolfcrypt/aes.h>
+#include <wolfssl/wolfcrypt/asn_public.h>
+#include <wolfssl/wolfcrypt/random.h>
+#include <wolfssl/wolfcrypt/sha256.h>
+#include <wolfssl/wolfcrypt/sha512.h>
+
+#define DEFAULT_BIND_IP   "192.168.1.100"
+#define DEFAULT_BIND_PORT 6000
+#define DTLS_MTU          1200
+
+#define DEFAULT_CERT_DIR  "host/certs_dilithium"
+#define DEFAULT_CIPHERS   "TLS13-AES128-GCM-SHA256"
+#define DEFAULT_PSK_IDENTITY "litex-dtls-client"
+#define DEFAULT_PSK_KEY   "litex-psk-key-13"
+
+#define FLEET_MAX_SESSIONS   4096
+#define FLEET_HASH_BUCKETS   4096   /* power of two */
+#define FLEET_CID_LEN        8
+#define FLEET_COOKIE_SECRET  32
+#define FLEET_COOKIE_ROTATE  30     /* default seconds a cookie key issues cookies */
+#define FLEET_IDLE_TIMEOUT_S 120
+#define FLEET_DGRAM_MAX      2048
+#define FLEET_BATCH          64     /* max datagrams per recvmmsg/sendmmsg */
+#define FLEET_RXQ            16     /* staged datagrams per session */
+#define FLEET_MAX_WORKERS    64
+#define FLEET_INBOX          256    /* handed-off datagrams per worker */
+#define FLEET_MAX_CRYPTO     64
+#define FLEET_TICKET_KEYS    4      /* current key + retired ones still accepted */
+#define FLEET_TICKET_ROTATE  3600   /* default seconds a key encrypts tickets */
+#define FLEET_SHM_BUCKETS    4096   /* power of two */
+#define FLEET_SHM_WAYS       4      /* sessions per bucket */
+#define FLEET_SHM_STRIPES    64     /* bucket locks */
+#define FLEET_SHM_ID_LEN     32
+#define FLEET_SHM_DER_MAX    1024   /* serialized WOLFSSL_SESSION */
+#define FLEET_SHM_LIFETIME   7200   /* seconds a cached session resumes */
+
+#define FLEET_HIST_BUCKETS   14
+#define FLEET_MAX_GROUPS     16
+#define FLEET_MAX_SUITES     16
+
+/* Worker counters have a single writer and are read by the metrics thread,
+ * so both sides use relaxed atomics; a single-writer add needs no locked
+ * instruction. */
+#define STAT_ADD(v, n) \
+    __atomic_store_n(&(v), __atomic_load_n(&(v), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+#define STAT_GET(v)    __atomic_load_n(&(v), __ATOMIC_RELAXED)
+
+#if defined(HAVE_SESSION_TICKET) && defined(HAVE_EXT_CACHE) && \
+    defined(WOLFSSL_TICKET_HAVE_ID) && !defined(NO_SESSION_CACHE)
+    #define FLEET_SHM_CACHE
+#endif
+
+typedef struct fleet fleet_t;
+
+/* Upper bounds of the handshake histogram buckets, in microseconds. */
+static const unsigned long long g_hist_le_us[FLEET_HIST_BUCKETS] = {
+    250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000,
+    250000, 500000, 1000000, 2500000, 5000000
+};
+
+typedef struct {
+    unsigned long long bucket[FLEET_HIST_BUCKETS + 1];   /* last is +Inf */
+    unsigned long long sum_us;
+    unsigned long long count;
+} fleet_hist_t;
+
+typedef struct {
+    const unsigned char* data;        /* points into the receive batch */
+    int len;
+    struct sockaddr_in from;
+} fleet_dgram_t;
+
+/* Owned copy of a datagram, for sessions whose handshake runs elsewhere. */
+typedef struct fleet_copy {
+    struct fleet_copy* next;
+    struct sockaddr_in from;
+    int len;
+    unsigned char data[];
+} fleet_copy_t;
+
+typedef struct fleet_session {
+    WOLFSSL* ssl;
+    fleet_t* fleet;
+    struct sockaddr_in peer;          /* key in the address index */
+    unsigned char cid[FLEET_CID_LEN]; /* CID we asked the peer to use */
+    int handshake_done;
+    unsigned int ch_seq;              /* message_seq of the ClientHello that created it */
+    fleet_dgram_t rxq[FLEET_RXQ];     /* staged for bio_recv, oldest first */
+    int rxq_head;
+    int rxq_count;
+    int ready;                        /* on the per-batch ready list */
+    long long deadline_ms;            /* retransmission timer, 0 = idle */
+    long long last_rx_ms;
+    /* Crypto pool hand-off; the I/O thread leaves ssl alone while busy. */
+    int busy;
+    int job_ret;                      /* session_handshake() result */
+    int job_err;
+    long long hs_cpu_ns;              /* CPU spent in wolfSSL_accept() */
+    long long hs_start_us;            /* cookie verified */
+    long long kx_us;                  /* ClientHello -> server flight */
+    long long verify_us;              /* client flight -> done */
+    int hs_steps;
+    /* Per-association counters, logged when the session ends. */
+    long long born_ms;
+    unsigned long rx_datagrams;
+    unsigned long tx_datagrams;
+    unsigned long long rx_bytes;
+    unsigned long long tx_bytes;
+    unsigned long retransmits;
+    unsigned int aead_failures;
+    unsigned int replay_drops;
+    fleet_copy_t* jobq;               /* datagrams owned by the running job */
+    fleet_copy_t* backlog;            /* arrived while busy / not yet sent */
+    fleet_copy_t* backlog_tail;
+    int backlog_count;
+    struct fleet_session* addr_next;
+    struct fleet_session* cid_next;
+    struct fleet_session* ready_next;
+    struct fleet_session* job_next;
+} fleet_session_t;
+
+typedef struct {
+    struct mmsghdr msgs[FLEET_BATCH];
+    struct iovec iov[FLEET_BATCH];
+    struct sockaddr_in addr[FLEET_BATCH];
+    unsigned char buf[FLEET_BATCH][FLEET_DGRAM_MAX];
+    int count;
+} fleet_batch_t;
+
+/* Datagrams another worker received for a CID this worker owns. */
+typedef struct {
+    pthread_mutex_t lock;
+    int efd;
+    int head;
+    int count;
+    struct {
+        struct sockaddr_in from;
+        int len;
+        unsigned char data[FLEET_DGRAM_MAX];
+    } slot[FLEET_INBOX];
+} fleet_inbox_t;
+
+/* HMAC-SHA256 state after the key blocks, copied per cookie. */
+typedef struct {
+    wc_Sha256 inner;
+    wc_Sha256 outer;
+} fleet_cookie_mac_t;
+
+struct fleet {
+    int id;
+    int nworkers;
+    fleet_t** workers;                /* all workers, for CID handoff */
+    pthread_t tid;
+    int sock;
+    int epfd;
+    int batch;                        /* datagrams per syscall (-m) */
+    int quiet;
+    int offload;                      /* handshakes go to the crypto pool */
+    fleet_inbox_t inbox;
+    fleet_session_t* done;            /* finished jobs, under inbox.lock */
+    WOLFSSL_CTX* ctx;
+    WC_RNG rng;
+    unsigned int cookie_gen;          /* g_cookies generation of the keys below */
+    long long cookie_checked_ms;
+    unsigned char cookie_secret[2][FLEET_COOKIE_SECRET];
+    fleet_cookie_mac_t cookie_mac[2];
+    fleet_session_t* listener;
+    fleet_session_t* by_addr[FLEET_HASH_BUCKETS];
+    fleet_session_t* by_cid[FLEET_HASH_BUCKETS];
+    fleet_session_t* ready;
+    fleet_batch_t rx;
+    fleet_batch_t tx;
+    int count;
+    int handshaking;                  /* sessions still in their handshake */
+    unsigned long cookies_sent;
+    unsigned long cookies_skipped;    /* acceptable key share, answered at once */
+    unsigned long cookie_rejects;     /* bad or foreign cookies, dropped */
+    unsigned long handshakes;
+    unsigned long dropped;
+    unsigned long rx_datagrams;
+    unsigned long rx_calls;
+    unsigned long tx_datagrams;
+    unsigned long tx_calls;
+    unsigned long tx_direct;          /* sent by crypto threads (fetch_add) */
+    unsigned long long rx_bytes;
+    unsigned long long tx_bytes;
+    unsigned long long tx_direct_bytes;
+    unsigned long retransmits;
+    unsigned long hs_failures;
+    unsigned long aead_failures;
+    unsigned long replay_drops;
+    fleet_hist_t hist_cookie;
+    fleet_hist_t hist_kx;
+    fleet_hist_t hist_verify;
+    fleet_hist_t hist_total;
+    unsigned long handoffs;
+    unsigned long offloaded;
+    unsigned long resumed;
+    unsigned long long full_cpu_ns;
+    unsigned long long resumed_cpu_ns;
+};
+
+/* Crypto threads shared by all workers. */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    fleet_session_t* head;
+    fleet_session_t* tail;
+    int stop;
+    int nthreads;
+    pthread_t tids[FLEET_MAX_CRYPTO];
+} fleet_pool_t;
+
+static fleet_pool_t g_pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, {0}
+};
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000L;
+}
+
+static long long now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000L;
+}
+
+/* Owner thread only. */
+static void hist_observe(fleet_hist_t* h, long long us)
+{
+    int i = 0;
+    while (i < FLEET_HIST_BUCKETS && (unsigned long long)us > g_hist_le_us[i])
+        i++;
+    STAT_ADD(h->bucket[i], 1);
+    STAT_ADD(h->sum_us, (unsigned long long)us);
+    STAT_ADD(h->count, 1);
+}
+
+static const char* peer_str(const struct sockaddr_in* sa, char* out, size_t len)
+{
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &sa->sin_addr, ip, sizeof(ip));
+    snprintf(out, len, "%s:%u", ip, ntohs(sa->sin_port));
+    return out;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Configuration                                                            */
+/* ------------------------------------------------------------------------ */
+
+typedef enum {
+    FLEET_AUTH_CERT,               /* certificates, client cert required */
+    FLEET_AUTH_RPK,                /* raw public keys (RFC 7250), pinned */
+    FLEET_AUTH_PSK                 /* external PSK, no certificates */
+} fleet_auth_t;
+
+typedef struct {
+    const char* name;
+    int group;
+    int hybrid;                    /* ECDHE + ML-KEM */
+} fleet_group_t;
+
+/* Named key exchange groups; "pqc" selects every hybrid, strongest first. */
+static const fleet_group_t g_group_names[] = {
+#if defined(HAVE_PQC) && !defined(WOLFSSL_NO_ML_KEM)
+    { "p384_mlkem1024",  WOLFSSL_SECP384R1MLKEM1024, 1 },
+    { "p384_mlkem768",   WOLFSSL_SECP384R1MLKEM768,  1 },
+    { "p256_mlkem768",   WOLFSSL_SECP256R1MLKEM768,  1 },
+    { "p256_mlkem512",   WOLFSSL_SECP256R1MLKEM512,  1 },
+#ifdef HAVE_CURVE25519
+    { "x25519_mlkem768", WOLFSSL_X25519MLKEM768,     1 },
+    { "x25519_mlkem512", WOLFSSL_X25519MLKEM512,     1 },
+#endif
+#ifdef WOLFSSL_MLKEM_KYBER
+    { "p384_kyber768",   WOLFSSL_P384_KYBER_LEVEL3,  1 },
+    { "p256_kyber768",   WOLFSSL_P256_KYBER_LEVEL3,  1 },
+    { "p256_kyber512",   WOLFSSL_P256_KYBER_LEVEL1,  1 },
+#ifdef HAVE_CURVE25519
+    { "x25519_kyber512", WOLFSSL_X25519_KYBER_LEVEL1, 1 },
+    { "x25519_kyber768", WOLFSSL_X25519_KYBER_LEVEL3, 1 },
+#endif
+#endif
+    { "mlkem1024",       WOLFSSL_ML_KEM_1024,        0 },
+    { "mlkem768",        WOLFSSL_ML_KEM_768,         0 },
+    { "mlkem512",        WOLFSSL_ML_KEM_512,         0 },
+#endif
+    { "p384",            WOLFSSL_ECC_SECP384R1,      0 },
+    { "p256",            WOLFSSL_ECC_SECP256R1,      0 },
+#ifdef HAVE_CURVE25519
+    { "x25519",          WOLFSSL_ECC_X25519,         0 },
+#endif
+};
+#define FLEET_GROUP_NAMES ((int)(sizeof(g_group_names) / sizeof(g_group_names[0])))
+
+/* Everything the server can be told at startup, from -f FILE and the
+ * command line. Workers and crypto threads only read it. */
+static struct {
+    char bind_ip[INET_ADDRSTRLEN];
+    int port;
+    fleet_auth_t auth;
+    char ca_file[256];
+    char cert_file[256];
+    char key_file[256];
+    char rpk_file[256];            /* our SubjectPublicKeyInfo, PEM */
+    char rpk_allow_file[256];      /* device public keys, PEM, one per device */
+    int verify_peer;
+    int cert_compress;
+    char psk_identity[128];
+    unsigned char psk_key[64];
+    unsigned int psk_len;
+    int groups[FLEET_MAX_GROUPS];  /* server preference order */
+    int ngroups;                   /* 0 = wolfSSL defaults */
+    char ciphers[256];
+    int mtu;
+    int group_messages;            /* send each flight as few MTU sized datagrams */
+    int short_header;              /* 8-bit seq, no length on app data */
+    int batch;
+    int workers;
+    int crypto;
+    int rotate;
+    int cookie_rotate;
+    int cookie_skip;               /* handshakes in progress below which no cookie is asked */
+    char shm_name[64];             /* "" = no shared cache */
+    int metrics_port;              /* 0 = no metrics */
+    int quiet;
+} g_cfg = {
+    .bind_ip = DEFAULT_BIND_IP,
+    .port = DEFAULT_BIND_PORT,
+    .auth = FLEET_AUTH_CERT,
+    .ca_file = DEFAULT_CERT_DIR "/ca-cert.pem",
+    .cert_file = DEFAULT_CERT_DIR "/server-cert.pem",
+    .key_file = DEFAULT_CERT_DIR "/server-key.pem",
+    .rpk_file = DEFAULT_CERT_DIR "/server-rpk.pem",
+    .rpk_allow_file = DEFAULT_CERT_DIR "/rpk-allow.pem",
+    .verify_peer = 1,
+    .psk_identity = DEFAULT_PSK_IDENTITY,
+    .psk_key = DEFAULT_PSK_KEY,
+    .psk_len = sizeof(DEFAULT_PSK_KEY) - 1,
+    .ciphers = DEFAULT_CIPHERS,
+    .mtu = DTLS_MTU,
+    .group_messages = 1,
+    .short_header = 1,
+    .batch = FLEET_BATCH,
+    .workers = 1,
+    .crypto = 0,
+    .rotate = FLEET_TICKET_ROTATE,
+    .cookie_rotate = FLEET_COOKIE_ROTATE,
+};
+
+static int cfg_str(char* dst, size_t len, const char* val)
+{
+    if (strlen(val) >= len)
+        return -1;
+    strcpy(dst, val);
+    return 0;
+}
+
+static int cfg_int(int* dst, const char* val, int lo, int hi)
+{
+    char* end;
+    long v = strtol(val, &end, 10);
+    if (*val == '\0' || *end != '\0' || v < lo || v > hi)
+        return -1;
+    *dst = (int)v;
+    return 0;
+}
+
+static int cfg_bool(int* dst, const char* val)
+{
+    if (strcmp(val, "yes") == 0 || strcmp(val, "on") == 0 || strcmp(val, "1") == 0)
+        *dst = 1;
+    else if (strcmp(val, "no") == 0 || strcmp(val, "off") == 0 || strcmp(val, "0") == 0)
+        *dst = 0;
+    else
+        return -1;
+    return 0;
+}
+
+static int cfg_hex(unsigned char* dst, unsigned int* len, size_t max, const char* val)
+{
+    size_t n = strlen(val);
+    if (n == 0 || n % 2 != 0 || n / 2 > max)
+        return -1;
+    for (size_t i = 0; i < n / 2; i++) {
+        unsigned int b;
+        if (!isxdigit((unsigned char)val[2 * i]) || !isxdigit((unsigned char)val[2 * i + 1]) ||
+            sscanf(val + 2 * i, "%2x", &b) != 1)
+            return -1;
+        dst[i] = (unsigned char)b;
+    }
+    *len = (unsigned int)(n / 2);
+    return 0;
+}
+
+/* Comma-separated group names in preference order, "pqc" or "default". */
+static int cfg_groups(const char* val)
+{
+    char list[256];
+    if (cfg_str(list, sizeof(list), val) != 0)
+        return -1;
+    g_cfg.ngroups = 0;
+    if (strcmp(list, "default") == 0)
+        return 0;
+
+    char* save = NULL;
+    for (char* tok = strtok_r(list, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        int found = 0;
+        for (int i = 0; i < FLEET_GROUP_NAMES; i++) {
+            if (strcmp(tok, g_group_names[i].name) != 0 &&
+                !(g_group_names[i].hybrid && strcmp(tok, "pqc") == 0))
+                continue;
+            if (g_cfg.ngroups == FLEET_MAX_GROUPS)
+                return -1;
+            g_cfg.groups[g_cfg.ngroups++] = g_group_names[i].group;
+            found = 1;
+        }
+        if (!found) {
+            fprintf(stderr, "[Config] unknown group '%s'\n", tok);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int cfg_set(const char* key, const char* val)
+{
+    int rc = -1;
+    if (strcmp(key, "bind") == 0) {
+        struct in_addr a;
+        if (inet_aton(val, &a) != 0)
+            rc = cfg_str(g_cfg.bind_ip, sizeof(g_cfg.bind_ip), val);
+    }
+    else if (strcmp(key, "port") == 0)
+        rc = cfg_int(&g_cfg.port, val, 1, 65535);
+    else if (strcmp(key, "auth") == 0) {
+        if (strcmp(val, "cert") == 0) {
+            g_cfg.auth = FLEET_AUTH_CERT;
+            rc = 0;
+        }
+        else if (strcmp(val, "rpk") == 0) {
+            g_cfg.auth = FLEET_AUTH_RPK;
+            rc = 0;
+        }
+        else if (strcmp(val, "psk") == 0) {
+            g_cfg.auth = FLEET_AUTH_PSK;
+            rc = 0;
+        }
+    }
+    else if (strcmp(key, "certs") == 0) {
+        rc = 0;
+        if (snprintf(g_cfg.ca_file, sizeof(g_cfg.ca_file), "%s/ca-cert.pem", val)
+                >= (int)sizeof(g_cfg.ca_file) ||
+            snprintf(g_cfg.cert_file, sizeof(g_cfg.cert_file), "%s/server-cert.pem", val)
+                >= (int)sizeof(g_cfg.cert_file) ||
+            snprintf(g_cfg.key_file, sizeof(g_cfg.key_file), "%s/server-key.pem", val)
+                >= (int)sizeof(g_cfg.key_file) ||
+            snprintf(g_cfg.rpk_file, sizeof(g_cfg.rpk_file), "%s/server-rpk.pem", val)
+                >= (int)sizeof(g_cfg.rpk_file) ||
+            snprintf(g_cfg.rpk_allow_file, sizeof(g_cfg.rpk_allow_file), "%s/rpk-allow.pem", val)
+                >= (int)sizeof(g_cfg.rpk_allow_file))
+            rc = -1;
+    }
+    else if (strcmp(key, "ca") == 0)
+        rc = cfg_str(g_cfg.ca_file, sizeof(g_cfg.ca_file), val);
+    else if (strcmp(key, "cert") == 0)
+        rc = cfg_str(g_cfg.cert_file, sizeof(g_cfg.cert_file), val);
+    else if (strcmp(key, "key") == 0)
+        rc = cfg_str(g_cfg.key_file, sizeof(g_cfg.key_file), val);
+    else if (strcmp(key, "rpk") == 0)
+        rc = cfg_str(g_cfg.rpk_file, sizeof(g_cfg.rpk_file), val);
+    else if (strcmp(key, "rpk_allow") == 0)
+        rc = cfg_str(g_cfg.rpk_allow_file, sizeof(g_cfg.rpk_allow_file), val);
+    else if (strcmp(key, "verify_peer") == 0)
+        rc = cfg_bool(&g_cfg.verify_peer, val);
+    else if (strcmp(key, "cert_compress") == 0)
+        rc = cfg_bool(&g_cfg.cert_compress, val);
+    else if (strcmp(key, "psk_identity") == 0)
+        rc = cfg_str(g_cfg.psk_identity, sizeof(g_cfg.psk_identity), val);
+    else if (strcmp(key, "psk_key") == 0)
+        rc = cfg_hex(g_cfg.psk_key, &g_cfg.psk_len, sizeof(g_cfg.psk_key), val);
+    else if (strcmp(key, "groups") == 0)
+        rc = cfg_groups(val);
+    else if (strcmp(key, "ciphers") == 0)
+        rc = cfg_str(g_cfg.ciphers, sizeof(g_cfg.ciphers), val);
+    else if (strcmp(key, "mtu") == 0)
+        rc = cfg_int(&g_cfg.mtu, val, 256, FLEET_DGRAM_MAX);
+    else if (strcmp(key, "group_messages") == 0)
+        rc = cfg_bool(&g_cfg.group_messages, val);
+    else if (strcmp(key, "short_header") == 0)
+        rc = cfg_bool(&g_cfg.short_header, val);
+    else if (strcmp(key, "batch") == 0)
+        rc = cfg_int(&g_cfg.batch, val, 1, FLEET_BATCH);
+    else if (strcmp(key, "workers") == 0)
+        rc = cfg_int(&g_cfg.workers, val, 1, FLEET_MAX_WORKERS);
+    else if (strcmp(key, "crypto") == 0)
+        rc = cfg_int(&g_cfg.crypto, val, 0, FLEET_MAX_CRYPTO);
+    else if (strcmp(key, "ticket_rotate") == 0)
+        rc = cfg_int(&g_cfg.rotate, val, 0, 7 * 24 * 3600);
+    else if (strcmp(key, "cookie_rotate") == 0)
+        rc = cfg_int(&g_cfg.cookie_rotate, val, 1, 3600);
+    else if (strcmp(key, "cookie_skip") == 0)
+        rc = cfg_int(&g_cfg.cookie_skip, val, 0, FLEET_MAX_SESSIONS);
+    else if (strcmp(key, "shm") == 0)
+        rc = cfg_str(g_cfg.shm_name, sizeof(g_cfg.shm_name), val);
+    else if (strcmp(key, "metrics") == 0)
+        rc = cfg_int(&g_cfg.metrics_port, val, 0, 65535);
+    else if (strcmp(key, "quiet") == 0)
+        rc = cfg_bool(&g_cfg.quiet, val);
+    else {
+        fprintf(stderr, "[Config] unknown setting '%s'\n", key);
+        return -1;
+    }
+    if (rc != 0)
+        fprintf(stderr, "[Config] bad value for %s: '%s'\n", key, val);
+    return rc;
+}
+
+static char* cfg_trim(char* s)
+{
+    while (isspace((unsigned char)*s))
+        s++;
+    char* e = s + strlen(s);
+    while (e > s && isspace((unsigned char)e[-1]))
+        *--e = '\0';
+    return s;
+}
+
+/* "key = value" lines; '#' starts a comment. */
+static int cfg_load(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "[Config] ✗ cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    char line[512];
+    int lineno = 0;
+    int rc = 0;
+    while (rc == 0 && fgets(line, sizeof(line), fp) != NULL) {
+        lineno++;
+        char* hash = strchr(line, '#');
+        if (hash != NULL)
+            *hash = '\0';
+        char* key = cfg_trim(line);
+        if (*key == '\0')
+            continue;
+        char* eq = strchr(key, '=');
+        if (eq == NULL) {
+            fprintf(stderr, "[Config] %s:%d: expected 'key = value'\n", path, lineno);
+            rc = -1;
+            break;
+        }
+        *eq = '\0';
+        if (cfg_set(cfg_trim(key), cfg_trim(eq + 1)) != 0) {
+            fprintf(stderr, "[Config] ✗ %s:%d\n", path, lineno);
+            rc = -1;
+        }
+    }
+    fclose(fp);
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Session tickets                                                          */
+/* ------------------------------------------------------------------------ */
+
+#ifdef HAVE_SESSION_TICKET
+typedef struct {
+    unsigned char name[WOLFSSL_TICKET_NAME_SZ];
+    unsigned char key[WOLFSSL_TICKET_KEY_SZ];
+    long long born_ms;                /* 0 = empty slot */
+    long long retired_ms;             /* 0 = encrypting new tickets */
+} fleet_ticket_key_t;
+
+/* Ticket key ring shared by all workers. The newest key seals new tickets;
+ * retired keys only open tickets for as long as the ticket hint promises. */
+static struct {
+    pthread_rwlock_t lock;
+    WC_RNG rng;
+    int rotate_s;
+    int current;
+    fleet_ticket_key_t keys[FLEET_TICKET_KEYS];
+    unsigned long issued;
+    unsigned long opened;
+    unsigned long refreshed;
+    unsigned long rejected;
+} g_tickets = { .lock = PTHREAD_RWLOCK_INITIALIZER, .current = -1 };
+
+static int ticket_lifetime_s(void)
+{
+    return g_tickets.rotate_s * (FLEET_TICKET_KEYS - 1);
+}
+
+/* Start a new key if the current one has encrypted for long enough.
+ * Called with the write lock held. */
+static int ticket_rotate_locked(long long now)
+{
+    if (g_tickets.current >= 0 &&
+        now - g_tickets.keys[g_tickets.current].born_ms < g_tickets.rotate_s * 1000LL)
+        return 0;
+
+    int next = (g_tickets.current + 1) % FLEET_TICKET_KEYS;
+    fleet_ticket_key_t* k = &g_tickets.keys[next];
+    if (wc_RNG_GenerateBlock(&g_tickets.rng, k->name, sizeof(k->name)) != 0 ||
+        wc_RNG_GenerateBlock(&g_tickets.rng, k->key, sizeof(k->key)) != 0)
+        return -1;
+    k->born_ms = now;
+    k->retired_ms = 0;
+    if (g_tickets.current >= 0)
+        g_tickets.keys[g_tickets.current].retired_ms = now;
+    g_tickets.current = next;
+    return 0;
+}
+
+/* Copy out the key to seal with (enc) or the one named by the ticket.
+ * Returns 0 when found, 1 when found but no longer current, -1 otherwise. */
+static int ticket_key_get(int enc, unsigned char* name, unsigned char* key)
+{
+    long long now = now_ms();
+    int ret = -1;
+
+    if (enc) {
+        pthread_rwlock_rdlock(&g_tickets.lock);
+        int stale = g_tickets.current < 0 ||
+            now - g_tickets.keys[g_tickets.current].born_ms >= g_tickets.rotate_s * 1000LL;
+        pthread_rwlock_unlock(&g_tickets.lock);
+        if (stale) {
+            pthread_rwlock_wrlock(&g_tickets.lock);
+            int r = ticket_rotate_locked(now);
+            pthread_rwlock_unlock(&g_tickets.lock);
+            if (r != 0)
+                return -1;
+        }
+    }
+
+    pthread_rwlock_rdlock(&g_tickets.lock);
+    if (enc) {
+        const fleet_ticket_key_t* k = &g_tickets.keys[g_tickets.current];
+        memcpy(name, k->name, sizeof(k->name));
+        memcpy(key, k->key, sizeof(k->key));
+        ret = 0;
+    }
+    else {
+        for (int i = 0; i < FLEET_TICKET_KEYS; i++) {
+            const fleet_ticket_key_t* k = &g_tickets.keys[i];
+            if (k->born_ms == 0 || memcmp(name, k->name, sizeof(k->name)) != 0)
+                continue;
+            if (k->retired_ms != 0 && now - k->retired_ms > ticket_lifetime_s() * 1000LL)
+                break;
+            memcpy(key, k->key, sizeof(k->key));
+            ret = k->retired_ms == 0 ? 0 : 1;
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&g_tickets.lock);
+    return ret;
+}
+
+/* wolfSSL ticket callback: AES-256-GCM over the internal ticket, the key
+ * name and IV bound in as AAD, tag in the first 16 bytes of mac. Opening a
+ * ticket needs nothing but the key ring. Runs on worker and crypto threads. */
+static int ticket_enc_cb(WOLFSSL* ssl, unsigned char key_name[WOLFSSL_TICKET_NAME_SZ],
+                         unsigned char iv[WOLFSSL_TICKET_IV_SZ],
+                         unsigned char mac[WOLFSSL_TICKET_MAC_SZ],
+                         int enc, unsigned char* ticket, int inLen, int* outLen,
+                         void* userCtx)
+{
+    unsigned char key[WOLFSSL_TICKET_KEY_SZ];
+    unsigned char aad[WOLFSSL_TICKET_NAME_SZ + WOLFSSL_TICKET_IV_SZ];
+    Aes aes;
+    int ret;
+
+    (void)userCtx;
+    int found = ticket_key_get(enc, key_name, key);
+    if (found < 0) {
+        if (!enc)
+            __atomic_fetch_add(&g_tickets.rejected, 1, __ATOMIC_RELAXED);
+        return WOLFSSL_TICKET_RET_REJECT;
+    }
+    if (enc) {
+        /* The connection's own RNG: safe on whichever thread runs it. */
+        WC_RNG* rng = wolfSSL_GetRNG(ssl);
+        if (rng == NULL || wc_RNG_GenerateBlock(rng, iv, WOLFSSL_TICKET_IV_SZ) != 0)
+            return WOLFSSL_TICKET_RET_REJECT;
+    }
+    memcpy(aad, key_name, WOLFSSL_TICKET_NAME_SZ);
+    memcpy(aad + WOLFSSL_TICKET_NAME_SZ, iv, WOLFSSL_TICKET_IV_SZ);
+
+    if (wc_AesInit(&aes, NULL, INVALID_DEVID) != 0)
+        return WOLFSSL_TICKET_RET_REJECT;
+    ret = wc_AesGcmSetKey(&aes, key, sizeof(key));
+    if (ret == 0 && enc) {
+        memset(mac, 0, WOLFSSL_TICKET_MAC_SZ);
+        ret = wc_AesGcmEncrypt(&aes, ticket, ticket, (word32)inLen, iv, GCM_NONCE_MID_SZ,
+                               mac, AES_BLOCK_SIZE, aad, sizeof(aad));
+    }
+    else if (ret == 0) {
+        ret = wc_AesGcmDecrypt(&aes, ticket, ticket, (word32)inLen, iv, GCM_NONCE_MID_SZ,
+                               mac, AES_BLOCK_SIZE, aad, sizeof(aad));
+    }
+    wc_AesFree(&aes);
+    memset(key, 0, sizeof(key));
+
+    if (ret != 0) {
+        if (!enc)
+            __atomic_fetch_add(&g_tickets.rejected, 1, __ATOMIC_RELAXED);
+        return WOLFSSL_TICKET_RET_REJECT;
+    }
+    *outLen = inLen;
+    if (enc) {
+        __atomic_fetch_add(&g_tickets.issued, 1, __ATOMIC_RELAXED);
+        return WOLFSSL_TICKET_RET_OK;
+    }
+    __atomic_fetch_add(found ? &g_tickets.refreshed : &g_tickets.opened, 1,
+                       __ATOMIC_RELAXED);
+    return found ? WOLFSSL_TICKET_RET_CREATE : WOLFSSL_TICKET_RET_OK;
+}
+#endif /* HAVE_SESSION_TICKET */
+
+/* ------------------------------------------------------------------------ */
+/* Session indices                                                          */
+/* ------------------------------------------------------------------------ */
+
+static unsigned int fnv1a(const unsigned char* p, size_t n)
+{
+    unsigned int h = 2166136261u;
+    while (n--) {
+        h ^= *p++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static unsigned int addr_bucket(const struct sockaddr_in* sa)
+{
+    unsigned char key[6];
+    memcpy(key, &sa->sin_addr.s_addr, 4);
+    memcpy(key + 4, &sa->sin_port, 2);
+    return fnv1a(key, sizeof(key)) & (FLEET_HASH_BUCKETS - 1);
+}
+
+static unsigned int cid_bucket(const unsigned char* cid)
+{
+    return fnv1a(cid, FLEET_CID_LEN) & (FLEET_HASH_BUCKETS - 1);
+}
+
+static int addr_equal(const struct sockaddr_in* a, const struct sockaddr_in* b)
+{
+    return a->sin_addr.s_addr == b->sin_addr.s_addr &&
+           a->sin_port == b->sin_port;
+}
+
+static fleet_session_t* find_by_addr(fleet_t* f, const struct sockaddr_in* sa)
+{
+    fleet_session_t* s = f->by_addr[addr_bucket(sa)];
+    while (s != NULL && !addr_equal(&s->peer, sa))
+        s = s->addr_next;
+    return s;
+}
+
+static fleet_session_t* find_by_cid(fleet_t* f, const unsigned char* cid)
+{
+    fleet_session_t* s = f->by_cid[cid_bucket(cid)];
+    while (s != NULL && memcmp(s->cid, cid, FLEET_CID_LEN) != 0)
+        s = s->cid_next;
+    return s;
+}
+
+static void addr_link(fleet_t* f, fleet_session_t* s)
+{
+    unsigned int b = addr_bucket(&s->peer);
+    s->addr_next = f->by_addr[b];
+    f->by_addr[b] = s;
+}
+
+static void addr_unlink(fleet_t* f, fleet_session_t* s)
+{
+    fleet_session_t** pp = &f->by_addr[addr_bucket(&s->peer)];
+    while (*pp != NULL && *pp != s)
+        pp = &(*pp)->addr_next;
+    if (*pp == s)
+        *pp = s->addr_next;
+    s->addr_next = NULL;
+}
+
+static void cid_link(fleet_t* f, fleet_session_t* s)
+{
+    unsigned int b = cid_bucket(s->cid);
+    s->cid_next = f->by_cid[b];
+    f->by_cid[b] = s;
+}
+
+static void cid_unlink(fleet_t* f, fleet_session_t* s)
+{
+    fleet_session_t** pp = &f->by_cid[cid_bucket(s->cid)];
+    while (*pp != NULL && *pp != s)
+        pp = &(*pp)->cid_next;
+    if (*pp == s)
+        *pp = s->cid_next;
+    s->cid_next = NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Shared-memory session cache                                              */
+/* ------------------------------------------------------------------------ */
+
+#ifdef FLEET_SHM_CACHE
+#define FLEET_SHM_MAGIC   0x53534c46u   /* "FLSS" */
+#define FLEET_SHM_VERSION 1
+
+typedef struct {
+    unsigned char id[FLEET_SHM_ID_LEN];
+    long long stored_s;               /* wall clock, 0 = empty */
+    unsigned int len;
+    unsigned char der[FLEET_SHM_DER_MAX];
+} fleet_shm_entry_t;
+
+/* Mapped by every worker of every server process. Each stripe lock guards
+ * the buckets congruent to it; the locks are robust so a process that dies
+ * holding one does not wedge the others. */
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int entry_size;
+    unsigned int entries;
+    pthread_mutex_t stripe[FLEET_SHM_STRIPES];
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long stores;
+    unsigned long long evictions;
+    unsigned long long oversize;
+    fleet_shm_entry_t entry[FLEET_SHM_BUCKETS * FLEET_SHM_WAYS];
+} fleet_shm_t;
+
+static fleet_shm_t* g_shm = NULL;
+
+static void shm_count(unsigned long long* c)
+{
+    __atomic_fetch_add(c, 1, __ATOMIC_RELAXED);
+}
+
+static void shm_lock(unsigned int bucket)
+{
+    pthread_mutex_t* m = &g_shm->stripe[bucket % FLEET_SHM_STRIPES];
+    if (pthread_mutex_lock(m) == EOWNERDEAD)
+        pthread_mutex_consistent(m);
+}
+
+static void shm_unlock(unsigned int bucket)
+{
+    pthread_mutex_unlock(&g_shm->stripe[bucket % FLEET_SHM_STRIPES]);
+}
+
+static fleet_shm_entry_t* shm_bucket(const unsigned char* id, unsigned int* bucket)
+{
+    *bucket = fnv1a(id, FLEET_SHM_ID_LEN) & (FLEET_SHM_BUCKETS - 1);
+    return &g_shm->entry[*bucket * FLEET_SHM_WAYS];
+}
+
+/* The ticket ID a client will present is the session's alternate ID.
+ * wolfSSL_SESSION_get_id() needs OPENSSL_EXTRA, so read it from the
+ * serialized form: side(1) bornOn(4) timeout(4) idLen(1) id masterSecret(48)
+ * haveEMS(1) altIdLen(1) altId. */
+static const unsigned char* shm_sess_id(const unsigned char* der, int len)
+{
+    int idx = 1 + 4 + 4;
+    if (idx >= len)
+        return NULL;
+    idx += 1 + der[idx] + 48 + 1;
+    if (idx + 1 + FLEET_SHM_ID_LEN > len || der[idx] != FLEET_SHM_ID_LEN)
+        return NULL;
+    return der + idx + 1;
+}
+
+/* wolfSSL new-session callback: serialize and store under the ticket ID.
+ * Returns 0, so wolfSSL keeps ownership of sess. */
+static int shm_sess_new(WOLFSSL* ssl, WOLFSSL_SESSION* sess)
+{
+    unsigned char der[FLEET_SHM_DER_MAX];
+    unsigned char* p = der;
+    unsigned int bucket;
+
+    (void)ssl;
+    int len = wolfSSL_i2d_SSL_SESSION(sess, NULL);
+    if (len <= 0 || len > FLEET_SHM_DER_MAX) {
+        shm_count(&g_shm->oversize);
+        return 0;
+    }
+    if (wolfSSL_i2d_SSL_SESSION(sess, &p) != len)
+        return 0;
+    const unsigned char* id = shm_sess_id(der, len);
+    if (id == NULL)
+        return 0;
+
+    long long now = (long long)time(NULL);
+    fleet_shm_entry_t* way = shm_bucket(id, &bucket);
+    fleet_shm_entry_t* slot = NULL;
+
+    shm_lock(bucket);
+    for (int i = 0; i < FLEET_SHM_WAYS && slot == NULL; i++) {
+        if (way[i].stored_s != 0 && memcmp(way[i].id, id, FLEET_SHM_ID_LEN) == 0)
+            slot = &way[i];
+    }
+    for (int i = 0; i < FLEET_SHM_WAYS && slot == NULL; i++) {
+        if (way[i].stored_s == 0 || now - way[i].stored_s > FLEET_SHM_LIFETIME)
+            slot = &way[i];
+    }
+    if (slot == NULL) {
+        slot = &way[0];
+        for (int i = 1; i < FLEET_SHM_WAYS; i++) {
+            if (way[i].stored_s < slot->stored_s)
+                slot = &way[i];
+        }
+        shm_count(&g_shm->evictions);
+    }
+    memcpy(slot->id, id, FLEET_SHM_ID_LEN);
+    memcpy(slot->der, der, (size_t)len);
+    slot->len = (unsigned int)len;
+    slot->stored_s = now;
+    shm_unlock(bucket);
+
+    shm_count(&g_shm->stores);
+    return 0;
+}
+
+/* wolfSSL get-session callback: a fresh WOLFSSL_SESSION that wolfSSL frees
+ * (copy = 0), or NULL on a miss. Runs on worker and crypto threads. */
+static WOLFSSL_SESSION* shm_sess_get(WOLFSSL* ssl, const unsigned char* id,
+                                     int id_len, int* copy)
+{
+    unsigned char der[FLEET_SHM_DER_MAX];
+    unsigned int len = 0;
+    unsigned int bucket;
+
+    (void)ssl;
+    *copy = 0;
+    if (id_len != FLEET_SHM_ID_LEN) {
+        shm_count(&g_shm->misses);
+        return NULL;
+    }
+
+    long long now = (long long)time(NULL);
+    fleet_shm_entry_t* way = shm_bucket(id, &bucket);
+    shm_lock(bucket);
+    for (int i = 0; i < FLEET_SHM_WAYS; i++) {
+        if (way[i].stored_s != 0 && now - way[i].stored_s <= FLEET_SHM_LIFETIME &&
+            memcmp(way[i].id, id, FLEET_SHM_ID_LEN) == 0) {
+            len = way[i].len;
+            memcpy(der, way[i].der, len);
+            break;
+        }
+    }
+    shm_unlock(bucket);
+
+    const unsigned char* p = der;
+    WOLFSSL_SESSION* sess = len > 0 ? wolfSSL_d2i_SSL_SESSION(NULL, &p, (long)len) : NULL;
+    shm_count(sess != NULL ? &g_shm->hits : &g_shm->misses);
+    return sess;
+}
+
+/* Map (creating or re-initializing if needed) the shared table. A table
+ * left by an earlier run with the same layout is kept as is. */
+static int shm_open_cache(const char* name)
+{
+    char path[96];
+    snprintf(path, sizeof(path), "/%s", name[0] == '/' ? name + 1 : name);
+
+    int fd = shm_open(path, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        perror("[Init] shm_open");
+        return -1;
+    }
+    flock(fd, LOCK_EX);
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 ||
+        (st.st_size != (off_t)sizeof(fleet_shm_t) &&
+         (ftruncate(fd, 0) < 0 || ftruncate(fd, sizeof(fleet_shm_t)) < 0))) {
+        perror("[Init] session cache size");
+        close(fd);
+        return -1;
+    }
+    void* map = mmap(NULL, sizeof(fleet_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("[Init] mmap");
+        close(fd);
+        return -1;
+    }
+    g_shm = (fleet_shm_t*)map;
+
+    int kept = 0;
+    if (g_shm->magic != FLEET_SHM_MAGIC || g_shm->version != FLEET_SHM_VERSION ||
+        g_shm->entry_size != sizeof(fleet_shm_entry_t) ||
+        g_shm->entries != FLEET_SHM_BUCKETS * FLEET_SHM_WAYS) {
+        memset(g_shm, 0, sizeof(*g_shm));
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        for (int i = 0; i < FLEET_SHM_STRIPES; i++)
+            pthread_mutex_init(&g_shm->stripe[i], &attr);
+        pthread_mutexattr_destroy(&attr);
+        g_shm->version = FLEET_SHM_VERSION;
+        g_shm->entry_size = sizeof(fleet_shm_entry_t);
+        g_shm->entries = FLEET_SHM_BUCKETS * FLEET_SHM_WAYS;
+        __atomic_store_n(&g_shm->magic, FLEET_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+    else {
+        long long now = (long long)time(NULL);
+        for (unsigned int i = 0; i < g_shm->entries; i++) {
+            if (g_shm->entry[i].stored_s != 0 &&
+                now - g_shm->entry[i].stored_s <= FLEET_SHM_LIFETIME)
+                kept++;
+        }
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    printf("Session cache: /dev/shm%s, %d sessions, %d kept from an earlier run\n",
+           path, FLEET_SHM_BUCKETS * FLEET_SHM_WAYS, kept);
+    return 0;
+}
+#endif /* FLEET_SHM_CACHE */
+
+/* ------------------------------------------------------------------------ */
+/* Batched socket I/O                                                       */
+/* ------------------------------------------------------------------------ */
+
+static void batch_init(fleet_batch_t* b)
+{
+    for (int i = 0; i < FLEET_BATCH; i++) {
+        b->iov[i].iov_base = b->buf[i];
+        b->iov[i].iov_len = FLEET_DGRAM_MAX;
+        b->msgs[i].msg_hdr.msg_name = &b->addr[i];
+        b->msgs[i].msg_hdr.msg_namelen = sizeof(b->addr[i]);
+        b->msgs[i].msg_hdr.msg_iov = &b->iov[i];
+        b->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    b->count = 0;
+}
+
+/* Push every staged datagram out with as few sendmmsg() calls as possible.
+ * A datagram the kernel refuses is dropped; DTLS retransmission covers it. */
+static void fleet_flush(fleet_t* f)
+{
+    int off = 0;
+    while (off < f->tx.count) {
+        int n = sendmmsg(f->sock, &f->tx.msgs[off], (unsigned int)(f->tx.count - off), 0);
+        STAT_ADD(f->tx_calls, 1);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR)
+                continue;
+            STAT_ADD(f->dropped, (unsigned long)(f->tx.count - off));
+            break;
+        }
+        unsigned long long bytes = 0;
+        for (int i = 0; i < n; i++)
+            bytes += f->tx.msgs[off + i].msg_len;
+        STAT_ADD(f->tx_datagrams, (unsigned long)n);
+        STAT_ADD(f->tx_bytes, bytes);
+        off += n;
+    }
+    f->tx.count = 0;
+}
+
+static int fleet_stage_tx(fleet_t* f, const char* buf, int sz,
+                          const struct sockaddr_in* to)
+{
+    if (sz > FLEET_DGRAM_MAX) {
+        fleet_flush(f);
+        STAT_ADD(f->tx_calls, 1);
+        if (sendto(f->sock, buf, (size_t)sz, 0, (const struct sockaddr*)to,
+                   sizeof(*to)) < 0)
+            return -1;
+        STAT_ADD(f->tx_datagrams, 1);
+        STAT_ADD(f->tx_bytes, (unsigned long long)sz);
+        return sz;
+    }
+
+    int i = f->tx.count++;
+    memcpy(f->tx.buf[i], buf, (size_t)sz);
+    f->tx.iov[i].iov_len = (size_t)sz;
+    f->tx.addr[i] = *to;
+    f->tx.msgs[i].msg_hdr.msg_namelen = sizeof(*to);
+    if (f->tx.count >= f->batch)
+        fleet_flush(f);
+    return sz;
+}
+
+/* ------------------------------------------------------------------------ */
+/* I/O callbacks: recv pops the session's staged datagrams, send stages     */
+/* into the outgoing batch for whatever peer wolfSSL currently trusts.      */
+/* ------------------------------------------------------------------------ */
+
+static int bio_recv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    fleet_session_t* s = (fleet_session_t*)ctx;
+    if (s == NULL)
+        return WOLFSSL_CBIO_ERR_GENERAL;
+
+    if (s->jobq != NULL) {
+        fleet_copy_t* c = s->jobq;
+        s->jobq = c->next;
+#ifdef WOLFSSL_DTLS_CID
+        if (!addr_equal(&c->from, &s->peer))
+            wolfSSL_dtls_set_pending_peer(ssl, &c->from, sizeof(c->from));
+#endif
+        int n = c->len < sz ? c->len : sz;
+        memcpy(buf, c->data, (size_t)n);
+        free(c);
+        return n;
+    }
+    if (s->rxq_count == 0)
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+
+    fleet_dgram_t* d = &s->rxq[s->rxq_head];
+    s->rxq_head = (s->rxq_head + 1) % FLEET_RXQ;
+    s->rxq_count--;
+
+#ifdef WOLFSSL_DTLS_CID
+    /* Matched by CID from a new address: let wolfSSL switch over only once
+     * this record authenticates. */
+    if (!addr_equal(&d->from, &s->peer))
+        wolfSSL_dtls_set_pending_peer(ssl, &d->from, sizeof(d->from));
+#else
+    (void)ssl;
+#endif
+
+    int n = d->len < sz ? d->len : sz;
+    memcpy(buf, d->data, (size_t)n);
+    return n;
+}
+
+static int bio_send(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    fleet_session_t* s = (fleet_session_t*)ctx;
+    if (s == NULL)
+        return WOLFSSL_CBIO_ERR_GENERAL;
+
+    struct sockaddr_in peer;
+    unsigned int peer_len = sizeof(peer);
+    if (wolfSSL_dtls_get_peer(ssl, &peer, &peer_len) != WOLFSSL_SUCCESS) {
+        printf("[UDP] ✗ bio_send: peer not set\n");
+        return WOLFSSL_CBIO_ERR_GENERAL;
+    }
+
+    if (s->busy) {
+        /* Crypto thread: the worker's batch is not ours to touch. */
+        if (sendto(s->fleet->sock, buf, (size_t)sz, 0, (struct sockaddr*)&peer,
+                   peer_len) < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return WOLFSSL_CBIO_ERR_WANT_WRITE;
+            perror("[UDP] ✗ sendto");
+            return WOLFSSL_CBIO_ERR_GENERAL;
+        }
+        __atomic_fetch_add(&s->fleet->tx_direct, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&s->fleet->tx_direct_bytes, (unsigned long long)sz,
+                           __ATOMIC_RELAXED);
+        s->tx_datagrams++;
+        s->tx_bytes += (unsigned long long)sz;
+        return sz;
+    }
+    if (fleet_stage_tx(s->fleet, buf, sz, &peer) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return WOLFSSL_CBIO_ERR_WANT_WRITE;
+        perror("[UDP] ✗ sendto");
+        return WOLFSSL_CBIO_ERR_GENERAL;
+    }
+    s->tx_datagrams++;
+    s->tx_bytes += (unsigned long long)sz;
+    return sz;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Session lifecycle                                                        */
+/* ------------------------------------------------------------------------ */
+
+static fleet_session_t* session_new(fleet_t* f)
+{
+    fleet_session_t* s = (fleet_session_t*)calloc(1, sizeof(*s));
+    if (s == NULL)
+        return NULL;
+    s->fleet = f;
+
+    s->ssl = wolfSSL_new(f->ctx);
+    if (s->ssl == NULL) {
+        free(s);
+        return NULL;
+    }
+    wolfSSL_SetIOReadCtx(s->ssl, s);
+    wolfSSL_SetIOWriteCtx(s->ssl, s);
+    wolfSSL_dtls_set_using_nonblock(s->ssl, 1);
+#ifdef WOLFSSL_DTLS_MTU
+    wolfSSL_dtls_set_mtu(s->ssl, (unsigned short)g_cfg.mtu);
+#endif
+#ifdef WOLFSSL_HAVE_DTLS13_SHORT_HEADER
+    wolfSSL_dtls13_set_short_header(s->ssl, g_cfg.short_header);
+#endif
+#ifdef WOLFSSL_DTLS_CH_FRAG
+    /* A HelloRetryRequest to a large hybrid group (P-384 + ML-KEM-1024)
+     * makes the second ClientHello span two datagrams. */
+    wolfSSL_dtls13_allow_ch_frag(s->ssl, 1);
+#endif
+
+    /* Every listener uses the worker's cookie keys, so a cookie stays valid
+     * even if the listener object is recycled between HRR and the second
+     * ClientHello. */
+    if (wolfSSL_send_hrr_cookie(s->ssl, f->cookie_secret[f->cookie_gen & 1],
+                                FLEET_COOKIE_SECRET) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Session] ✗ wolfSSL_send_hrr_cookie failed\n");
+        wolfSSL_free(s->ssl);
+        free(s);
+        return NULL;
+    }
+
+    /* Offer a server-chosen CID; peers that do not negotiate it are simply
+     * found by address instead. */
+    do {
+        wc_RNG_GenerateBlock(&f->rng, s->cid, FLEET_CID_LEN);
+        s->cid[0] = (unsigned char)f->id;
+    } while (find_by_cid(f, s->cid) != NULL);
+#ifdef WOLFSSL_DTLS_CID
+    if (wolfSSL_dtls_cid_use(s->ssl) != WOLFSSL_SUCCESS ||
+        wolfSSL_dtls_cid_set(s->ssl, s->cid, FLEET_CID_LEN) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Session] ⚠ CID setup failed, address demux only\n");
+    }
+#endif
+    return s;
+}
+
+static void copies_free(fleet_copy_t* c)
+{
+    while (c != NULL) {
+        fleet_copy_t* next = c->next;
+        free(c);
+        c = next;
+    }
+}
+
+static void session_free(fleet_t* f, fleet_session_t* s, const char* why)
+{
+    char who[32];
+    if (why != NULL && !f->quiet) {
+        printf("[Session] %s closed (%s), %d active\n",
+               peer_str(&s->peer, who, sizeof(who)), why, f->count - 1);
+        printf("[Session] %s age_ms=%lld rx_datagrams=%lu rx_bytes=%llu tx_datagrams=%lu "
+               "tx_bytes=%llu retransmits=%lu aead_failures=%u replay_drops=%u\n",
+               who, now_ms() - s->born_ms, s->rx_datagrams, s->rx_bytes, s->tx_datagrams,
+               s->tx_bytes, s->retransmits, s->aead_failures, s->replay_drops);
+    }
+    if (s->handshake_done)
+        wolfSSL_shutdown(s->ssl);
+    else
+        f->handshaking--;
+    addr_unlink(f, s);
+    cid_unlink(f, s);
+    if (s->ready) {
+        fleet_session_t** pp = &f->ready;
+        while (*pp != s)
+            pp = &(*pp)->ready_next;
+        *pp = s->ready_next;
+    }
+    copies_free(s->jobq);
+    copies_free(s->backlog);
+    wolfSSL_free(s->ssl);
+    free(s);
+    STAT_ADD(f->count, -1);
+}
+
+static void session_arm_timer(fleet_session_t* s)
+{
+    /* After the handshake the NewSessionTicket is still retransmitted until
+     * the device ACKs it; losing it would cost the device its resumption. */
+    if (s->handshake_done && !wolfSSL_dtls13_has_pending_msg(s->ssl)) {
+        s->deadline_ms = 0;
+        return;
+    }
+    long long tmo = (long long)wolfSSL_dtls_get_current_timeout(s->ssl) * 1000LL;
+    if (wolfSSL_dtls13_use_quick_timeout(s->ssl))
+        tmo /= 4;
+    s->deadline_ms = now_ms() + tmo;
+}
+
+/* One wolfSSL_accept() step. Touches only s->ssl, so it may run on a
+ * crypto thread. Returns 1 when complete, 0 when it needs more datagrams
+ * and -1 on failure (error code in s->job_err). */
+static int session_handshake(fleet_session_t* s)
+{
+    struct timespec t0, t1;
+    long long start_us = now_us();
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t0);
+    int ret = wolfSSL_accept(s->ssl);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t1);
+    s->hs_cpu_ns += (t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec);
+    /* The first step answers the ClientHello (key exchange, signature);
+     * the rest process the client's Certificate/CertificateVerify/Finished. */
+    if (s->hs_steps++ == 0)
+        s->kx_us += now_us() - start_us;
+    else
+        s->verify_us += now_us() - start_us;
+    if (ret == WOLFSSL_SUCCESS)
+        return 1;
+    int err = wolfSSL_get_error(s->ssl, ret);
+    if (err == WOLFSSL_ERROR_WANT_READ || err == WOLFSSL_ERROR_WANT_WRITE)
+        return 0;
+    s->job_err = err;
+    return -1;
+}
+
+/* Bookkeeping for a session_handshake() result, on the worker thread.
+ * Returns -1 if the session was freed. */
+static int session_handshake_done(fleet_t* f, fleet_session_t* s, int r)
+{
+    char who[32];
+
+    if (r < 0) {
+        STAT_ADD(f->hs_failures, 1);
+        char error_buf[80];
+        wolfSSL_ERR_error_string(s->job_err, error_buf);
+        fprintf(stderr, "[Handshake] ✗ %s failed: %d (%s)\n",
+                peer_str(&s->peer, who, sizeof(who)), s->job_err, error_buf);
+        session_free(f, s, "handshake error");
+        return -1;
+    }
+    if (r == 0) {
+        session_arm_timer(s);
+        return 0;
+    }
+
+    int resumed = wolfSSL_session_reused(s->ssl);
+    s->handshake_done = 1;
+    session_arm_timer(s);
+    f->handshaking--;
+    STAT_ADD(f->handshakes, 1);
+    if (resumed) {
+        STAT_ADD(f->resumed, 1);
+        STAT_ADD(f->resumed_cpu_ns, (unsigned long long)s->hs_cpu_ns);
+    }
+    else {
+        STAT_ADD(f->full_cpu_ns, (unsigned long long)s->hs_cpu_ns);
+    }
+    hist_observe(&f->hist_kx, s->kx_us);
+    hist_observe(&f->hist_verify, s->verify_us);
+    hist_observe(&f->hist_total, now_us() - s->hs_start_us);
+    if (!f->quiet)
+        printf("[Handshake] ✓ %s %s %s%s%s\n", peer_str(&s->peer, who, sizeof(who)),
+               wolfSSL_get_version(s->ssl), wolfSSL_get_cipher(s->ssl),
+               resumed ? " (resumed)" : "",
+#ifdef WOLFSSL_DTLS_CID
+               wolfSSL_dtls_cid_is_enabled(s->ssl) ? " (CID)" : "");
+#else
+               "");
+#endif
+    return 0;
+}
+
+/* Queue a handshake step on the crypto pool with everything the session
+ * has collected so far. */
+static void session_submit(fleet_t* f, fleet_session_t* s)
+{
+    s->jobq = s->backlog;
+    s->backlog = s->backlog_tail = NULL;
+    s->backlog_count = 0;
+    s->busy = 1;
+    s->job_next = NULL;
+    STAT_ADD(f->offloaded, 1);
+
+    pthread_mutex_lock(&g_pool.lock);
+    if (g_pool.tail != NULL)
+        g_pool.tail->job_next = s;
+    else
+        g_pool.head = s;
+    g_pool.tail = s;
+    pthread_cond_signal(&g_pool.cond);
+    pthread_mutex_unlock(&g_pool.lock);
+}
+
+static void* crypto_thread(void* arg)
+{
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&g_pool.lock);
+        while (g_pool.head == NULL && !g_pool.stop)
+            pthread_cond_wait(&g_pool.cond, &g_pool.lock);
+        if (g_pool.head == NULL) {
+            pthread_mutex_unlock(&g_pool.lock);
+            return NULL;
+        }
+        fleet_session_t* s = g_pool.head;
+        g_pool.head = s->job_next;
+        if (g_pool.head == NULL)
+            g_pool.tail = NULL;
+        pthread_mutex_unlock(&g_pool.lock);
+
+        s->job_ret = session_handshake(s);
+
+        fleet_t* f = s->fleet;
+        pthread_mutex_lock(&f->inbox.lock);
+        s->job_next = f->done;
+        f->done = s;
+        pthread_mutex_unlock(&f->inbox.lock);
+        uint64_t one = 1;
+        if (write(f->inbox.efd, &one, sizeof(one)) < 0)
+            perror("[Crypto] eventfd");
+    }
+}
+
+/* Run the handshake / echo loop on whatever the session has buffered.
+ * Returns 0 to keep the session, -1 if it was freed. */
+static int session_drive(fleet_t* f, fleet_session_t* s)
+{
+    char who[32];
+    int ret, err;
+
+    if (!s->handshake_done) {
+        if (f->offload) {
+            session_submit(f, s);
+            return 0;
+        }
+        if (session_handshake_done(f, s, session_handshake(s)) < 0)
+            return -1;
+        if (!s->handshake_done)
+            return 0;
+    }
+
+    char buf[2048];
+    for (;;) {
+        ret = wolfSSL_read(s->ssl, buf, sizeof(buf));
+        if (ret > 0) {
+            if (!f->quiet)
+                printf("[Data] %s: %d bytes \"%.*s\"\n",
+                       peer_str(&s->peer, who, sizeof(who)), ret, ret, buf);
+            if (wolfSSL_write(s->ssl, buf, ret) != ret)
+                fprintf(stderr, "[Data] ✗ echo to %s failed\n",
+                        peer_str(&s->peer, who, sizeof(who)));
+            continue;
+        }
+        err = wolfSSL_get_error(s->ssl, ret);
+        if (err == WOLFSSL_ERROR_WANT_READ || err == WOLFSSL_ERROR_WANT_WRITE) {
+            /* The device's ACK stops the ticket's retransmission timer. */
+            if (!wolfSSL_dtls13_has_pending_msg(s->ssl))
+                s->deadline_ms = 0;
+            return 0;
+        }
+        if (err == WOLFSSL_ERROR_ZERO_RETURN) {
+            session_free(f, s, "close_notify");
+            return -1;
+        }
+        fprintf(stderr, "[Data] ✗ %s read error %d\n",
+                peer_str(&s->peer, who, sizeof(who)), err);
+        session_free(f, s, "read error");
+        return -1;
+    }
+}
+
+/* The address wolfSSL trusts may have moved after a CID-matched record was
+ * authenticated (wolfSSL_dtls_set_pending_peer); follow it in the index. */
+static void session_track_peer(fleet_t* f, fleet_session_t* s)
+{
+    struct sockaddr_in peer;
+    unsigned int peer_len = sizeof(peer);
+    char from[32], to[32];
+
+    if (s->busy)
+        return;
+    if (wolfSSL_dtls_get_peer(s->ssl, &peer, &peer_len) != WOLFSSL_SUCCESS ||
+        addr_equal(&peer, &s->peer))
+        return;
+
+    fleet_session_t* other = find_by_addr(f, &peer);
+    if (other != NULL && other != s && !other->busy)
+        session_free(f, other, "address taken over");
+
+    if (!f->quiet)
+        printf("[Session] %s migrated to %s\n",
+                   peer_str(&s->peer, from, sizeof(from)), peer_str(&peer, to, sizeof(to)));
+    addr_unlink(f, s);
+    s->peer = peer;
+    addr_link(f, s);
+}
+
+/* Fold wolfSSL's per-connection drop counters into the worker totals. */
+static void session_account(fleet_t* f, fleet_session_t* s)
+{
+#ifdef WOLFSSL_DTLS_DROP_STATS
+    word32 mac = 0, replay = 0;
+    if (s->busy || wolfSSL_dtls_get_drop_stats(s->ssl, &mac, &replay) != WOLFSSL_SUCCESS)
+        return;
+    STAT_ADD(f->aead_failures, (unsigned long)(mac - s->aead_failures));
+    STAT_ADD(f->replay_drops, (unsigned long)(replay - s->replay_drops));
+    s->aead_failures = mac;
+    s->replay_drops = replay;
+#else
+    (void)f;
+    (void)s;
+#endif
+}
+
+/* ------------------------------------------------------------------------ */
+/* Datagram dispatch                                                        */
+/* ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+/* Stateless cookie stage                                                   */
+/* ------------------------------------------------------------------------ */
+
+/* Cookie keys shared by all workers. A new key takes over every
+ * cookie_rotate seconds and the previous one still verifies, so a cookie
+ * stays good for at least one rotation period. */
+static struct {
+    pthread_rwlock_t lock;
+    WC_RNG rng;
+    int rotate_s;
+    unsigned int gen;                 /* secret[gen & 1] issues cookies */
+    long long born_ms;
+    unsigned char secret[2][FLEET_COOKIE_SECRET];
+} g_cookies = { .lock = PTHREAD_RWLOCK_INITIALIZER };
+
+/* The configured cipher suites, in preference order. */
+static unsigned char g_suites[FLEET_MAX_SUITES][2];
+static int g_nsuites;
+
+/* RFC 8446 4.1.3: SHA-256("HelloRetryRequest"). */
+static const unsigned char g_hrr_random[32] = {
+    0xcf, 0x21, 0xad, 0x74, 0xe5, 0x9a, 0x61, 0x11, 0xbe, 0x1d, 0x8c, 0x02,
+    0x1e, 0x65, 0xb8, 0x91, 0xc2, 0xa2, 0x11, 0x16, 0x7a, 0xbb, 0x8c, 0x5e,
+    0x07, 0x9e, 0x09, 0xe2, 0xc8, 0xa8, 0x33, 0x9c
+};
+
+/* The ClientHello fields the cookie stage looks at; pointers into the
+ * received datagram. */
+typedef struct {
+    const unsigned char* rec_seq;     /* 6 bytes, echoed in the HRR record */
+    const unsigned char* msg_seq;     /* 2 bytes, echoed in the HRR message */
+    const unsigned char* body;
+    unsigned int body_len;
+    const unsigned char* sid;
+    unsigned int sid_len;
+    const unsigned char* suites;
+    unsigned int suites_len;
+    const unsigned char* groups;      /* supported_groups list */
+    unsigned int groups_len;
+    const unsigned char* shares;      /* key_share client_shares */
+    unsigned int shares_len;
+    const unsigned char* cookie;      /* NULL = first ClientHello */
+    unsigned int cookie_len;
+    int dtls13;
+    int sig_algs;
+} fleet_ch_t;
+
+static unsigned int get16(const unsigned char* p)
+{
+    return (unsigned int)p[0] << 8 | p[1];
+}
+
+static unsigned int get24(const unsigned char* p)
+{
+    return (unsigned int)p[0] << 16 | (unsigned int)p[1] << 8 | p[2];
+}
+
+static int cookie_suites_init(void)
+{
+    char list[sizeof(g_cfg.ciphers)];
+    char* save = NULL;
+    strcpy(list, g_cfg.ciphers);
+    g_nsuites = 0;
+    for (char* tok = strtok_r(list, ":", &save); tok != NULL && g_nsuites < FLEET_MAX_SUITES;
+         tok = strtok_r(NULL, ":", &save)) {
+        unsigned char cs0, cs;
+        int flags = 0;
+        if (wolfSSL_get_cipher_suite_from_name(tok, &cs0, &cs, &flags) == 0) {
+            g_suites[g_nsuites][0] = cs0;
+            g_suites[g_nsuites][1] = cs;
+            g_nsuites++;
+        }
+    }
+    return g_nsuites;
+}
+
+static int cookie_keys_init(int rotate_s)
+{
+    if (wc_InitRng(&g_cookies.rng) != 0 ||
+        wc_RNG_GenerateBlock(&g_cookies.rng, g_cookies.secret[0], FLEET_COOKIE_SECRET) != 0 ||
+        wc_RNG_GenerateBlock(&g_cookies.rng, g_cookies.secret[1], FLEET_COOKIE_SECRET) != 0)
+        return -1;
+    g_cookies.rotate_s = rotate_s;
+    g_cookies.born_ms = now_ms();
+    return 0;
+}
+
+/* HMAC-SHA256 with the key's ipad/opad blocks already absorbed; the same
+ * MAC wolfSSL's TlsCheckCookie computes. */
+static void cookie_mac_key(fleet_cookie_mac_t* m, const unsigned char* key)
+{
+    unsigned char ipad[WC_SHA256_BLOCK_SIZE], opad[WC_SHA256_BLOCK_SIZE];
+    memset(ipad, 0x36, sizeof(ipad));
+    memset(opad, 0x5c, sizeof(opad));
+    for (int i = 0; i < FLEET_COOKIE_SECRET; i++) {
+        ipad[i] ^= key[i];
+        opad[i] ^= key[i];
+    }
+    wc_InitSha256(&m->inner);
+    wc_Sha256Update(&m->inner, ipad, sizeof(ipad));
+    wc_InitSha256(&m->outer);
+    wc_Sha256Update(&m->outer, opad, sizeof(opad));
+}
+
+/* MAC over the cookie data and the peer address it was issued to. */
+static void cookie_mac(fleet_cookie_mac_t* m, const unsigned char* data, unsigned int len,
+                       const struct sockaddr_in* peer, unsigned char* out)
+{
+    wc_Sha256 h;
+    unsigned char inner[WC_SHA256_DIGEST_SIZE];
+    wc_Sha256Copy(&m->inner, &h);
+    wc_Sha256Update(&h, data, len);
+    wc_Sha256Update(&h, (const unsigned char*)peer, sizeof(*peer));
+    wc_Sha256Final(&h, inner);
+    wc_Sha256Free(&h);
+    wc_Sha256Copy(&m->outer, &h);
+    wc_Sha256Update(&h, inner, sizeof(inner));
+    wc_Sha256Final(&h, out);
+    wc_Sha256Free(&h);
+}
+
+/* Rotate the shared key when due and pick up a new one; at most once a
+ * second per worker. */
+static void cookie_refresh(fleet_t* f, long long now)
+{
+    int first = f->cookie_checked_ms == 0;
+    if (!first && now - f->cookie_checked_ms < 1000)
+        return;
+    f->cookie_checked_ms = now;
+
+    pthread_rwlock_rdlock(&g_cookies.lock);
+    int due = now - g_cookies.born_ms >= g_cookies.rotate_s * 1000LL;
+    pthread_rwlock_unlock(&g_cookies.lock);
+    if (due) {
+        pthread_rwlock_wrlock(&g_cookies.lock);
+        if (now - g_cookies.born_ms >= g_cookies.rotate_s * 1000LL &&
+            wc_RNG_GenerateBlock(&g_cookies.rng, g_cookies.secret[(g_cookies.gen + 1) & 1],
+                                 FLEET_COOKIE_SECRET) == 0) {
+            g_cookies.gen++;
+            g_cookies.born_ms = now;
+        }
+        pthread_rwlock_unlock(&g_cookies.lock);
+    }
+
+    pthread_rwlock_rdlock(&g_cookies.lock);
+    if (first || f->cookie_gen != g_cookies.gen) {
+        f->cookie_gen = g_cookies.gen;
+        memcpy(f->cookie_secret, g_cookies.secret, sizeof(f->cookie_secret));
+        cookie_mac_key(&f->cookie_mac[0], f->cookie_secret[0]);
+        cookie_mac_key(&f->cookie_mac[1], f->cookie_secret[1]);
+    }
+    pthread_rwlock_unlock(&g_cookies.lock);
+}
+
+/* 1 = one complete epoch 0 ClientHello, 0 = a well-formed record this
+ * stage leaves to wolfSSL (fragment, legacy cookie, several records),
+ * -1 = nothing that can start a connection. */
+static int ch_parse(const unsigned char* p, int len, fleet_ch_t* ch)
+{
+    memset(ch, 0, sizeof(*ch));
+    /* DTLSPlaintext: type, version, epoch, sequence_number[6], length */
+    if (len < 13 + 12 || p[0] != 22 || p[1] != 0xfe || get16(p + 3) != 0)
+        return -1;
+    unsigned int rec_len = get16(p + 11);
+    if (13 + rec_len > (unsigned int)len || rec_len < 12 || p[13] != 1)
+        return -1;
+    ch->rec_seq = p + 5;
+
+    /* Handshake: msg_type, length, message_seq, fragment_offset, fragment_length */
+    const unsigned char* hs = p + 13;
+    unsigned int msg_len = get24(hs + 1);
+    ch->msg_seq = hs + 4;
+    if (get24(hs + 6) != 0 || get24(hs + 9) != msg_len)
+        return 0;
+    if (12 + msg_len > rec_len)
+        return -1;
+    if (13 + rec_len != (unsigned int)len || 12 + msg_len != rec_len)
+        return 0;
+
+    const unsigned char* b = hs + 12;
+    const unsigned char* end = b + msg_len;
+    ch->body = b;
+    ch->body_len = msg_len;
+    if (end - b < 2 + 32 + 1)
+        return -1;
+    b += 2 + 32;
+    ch->sid_len = *b++;
+    ch->sid = b;
+    if (ch->sid_len > 32 || end - b < (long)ch->sid_len + 1)
+        return -1;
+    b += ch->sid_len;
+    unsigned int legacy_cookie = *b++;
+    if (end - b < (long)legacy_cookie + 2)
+        return -1;
+    if (legacy_cookie != 0)
+        return 0;
+    ch->suites_len = get16(b);
+    ch->suites = b + 2;
+    b += 2;
+    if (end - b < (long)ch->suites_len + 1 || ch->suites_len % 2 != 0)
+        return -1;
+    b += ch->suites_len;
+    unsigned int comp = *b++;
+    if (end - b < (long)comp + 2)
+        return -1;
+    b += comp;
+    unsigned int ext_len = get16(b);
+    b += 2;
+    if (end - b != (long)ext_len)
+        return -1;
+
+    while (b < end) {
+        if (end - b < 4)
+            return -1;
+        unsigned int type = get16(b);
+        unsigned int elen = get16(b + 2);
+        const unsigned char* e = b + 4;
+        if (end - e < (long)elen)
+            return -1;
+        b = e + elen;
+        switch (type) {
+        case 43:                      /* supported_versions */
+            if (elen < 1 || e[0] + 1u != elen)
+                return -1;
+            for (unsigned int i = 1; i + 1 < elen; i += 2) {
+                if (e[i] == 0xfe && e[i + 1] == 0xfc)
+                    ch->dtls13 = 1;
+            }
+            break;
+        case 10:                      /* supported_groups */
+            if (elen < 2 || get16(e) + 2 != elen || elen % 2 != 0)
+                return -1;
+            ch->groups = e + 2;
+            ch->groups_len = elen - 2;
+            break;
+        case 51:                      /* key_share */
+            if (elen < 2 || get16(e) + 2 != elen)
+                return -1;
+            ch->shares = e + 2;
+            ch->shares_len = elen - 2;
+            break;
+        case 44:                      /* cookie */
+            if (elen < 3 || get16(e) + 2 != elen)
+                return -1;
+            ch->cookie = e + 2;
+            ch->cookie_len = elen - 2;
+            break;
+        case 13:                      /* signature_algorithms */
+            ch->sig_algs = 1;
+            break;
+        default:
+            break;
+        }
+    }
+    return 1;
+}
+
+static int group_acceptable(int group)
+{
+    if (g_cfg.ngroups > 0) {
+        for (int i = 0; i < g_cfg.ngroups; i++) {
+            if (g_cfg.groups[i] == group)
+                return 1;
+        }
+        return 0;
+    }
+    for (int i = 0; i < FLEET_GROUP_NAMES; i++) {
+        if (g_group_names[i].group == group)
+            return 1;
+    }
+    return 0;
+}
+
+/* The group the HRR asks for: 0 when a client key share is already usable,
+ * else the server's favourite among the client's supported_groups, -1 when
+ * nothing matches. */
+static int ch_hrr_group(const fleet_ch_t* ch)
+{
+    for (unsigned int i = 0; i + 4 <= ch->shares_len; i += 4 + get16(ch->shares + i + 2)) {
+        if (group_acceptable((int)get16(ch->shares + i)))
+            return 0;
+    }
+
+    int n = g_cfg.ngroups > 0 ? g_cfg.ngroups : FLEET_GROUP_NAMES;
+    for (int i = 0; i < n; i++) {
+        int want = g_cfg.ngroups > 0 ? g_cfg.groups[i] : g_group_names[i].group;
+        for (unsigned int j = 0; j + 1 < ch->groups_len; j += 2) {
+            if ((int)get16(ch->groups + j) == want)
+                return want;
+        }
+    }
+    return -1;
+}
+
+/* Answer a first ClientHello with a HelloRetryRequest built here, in the
+ * exact layout wolfSSL's RestartHandshakeHashWithCookie rebuilds from the
+ * cookie. Returns 0 to leave the ClientHello to the wolfSSL listener. */
+static int cookie_reply(fleet_t* f, const struct sockaddr_in* from, const fleet_ch_t* ch)
+{
+    if (!ch->dtls13 || ch->shares == NULL || ch->groups == NULL ||
+        (g_cfg.auth != FLEET_AUTH_PSK && !ch->sig_algs))
+        return 0;
+
+    const unsigned char* suite = NULL;
+    for (int i = 0; i < g_nsuites && suite == NULL; i++) {
+        for (unsigned int j = 0; j < ch->suites_len; j += 2) {
+            if (ch->suites[j] == g_suites[i][0] && ch->suites[j + 1] == g_suites[i][1])
+                suite = g_suites[i];
+        }
+    }
+    int group = ch_hrr_group(ch);
+    if (suite == NULL || group < 0)
+        return 0;
+
+    /* Cookie data = hash length | ClientHello hash | suite | [group] */
+    unsigned char cookie[1 + WC_MAX_DIGEST_SIZE + 4 + WC_SHA256_DIGEST_SIZE];
+    unsigned char hs_hdr[4] = { 1, (unsigned char)(ch->body_len >> 16),
+                                (unsigned char)(ch->body_len >> 8),
+                                (unsigned char)ch->body_len };
+    unsigned int n = 0;
+    if (suite[0] == 0x13 && suite[1] == 0x02) {
+#ifdef WOLFSSL_SHA384
+        wc_Sha384 sha;
+        wc_InitSha384(&sha);
+        wc_Sha384Update(&sha, hs_hdr, sizeof(hs_hdr));
+        wc_Sha384Update(&sha, ch->body, ch->body_len);
+        cookie[n++] = WC_SHA384_DIGEST_SIZE;
+        wc_Sha384Final(&sha, cookie + n);
+        wc_Sha384Free(&sha);
+        n += WC_SHA384_DIGEST_SIZE;
+#else
+        return 0;
+#endif
+    }
+    else {
+        wc_Sha256 sha;
+        wc_InitSha256(&sha);
+        wc_Sha256Update(&sha, hs_hdr, sizeof(hs_hdr));
+        wc_Sha256Update(&sha, ch->body, ch->body_len);
+        cookie[n++] = WC_SHA256_DIGEST_SIZE;
+        wc_Sha256Final(&sha, cookie + n);
+        wc_Sha256Free(&sha);
+        n += WC_SHA256_DIGEST_SIZE;
+    }
+    cookie[n++] = suite[0];
+    cookie[n++] = suite[1];
+    if (group > 0) {
+        cookie[n++] = (unsigned char)(group >> 8);
+        cookie[n++] = (unsigned char)group;
+    }
+    cookie_mac(&f->cookie_mac[f->cookie_gen & 1], cookie, n, from, cookie + n);
+    n += WC_SHA256_DIGEST_SIZE;
+
+    /* Extensions: [key_share(group)] supported_versions(DTLS 1.3) cookie */
+    unsigned char out[13 + 12 + 2 + 32 + 1 + 32 + 3 + 2 + 6 + 6 + 6 + sizeof(cookie)];
+    unsigned int ext_len = (group > 0 ? 6 : 0) + 6 + 6 + n;
+    unsigned int body_len = 2 + 32 + 1 + ch->sid_len + 3 + 2 + ext_len;
+    unsigned int rec_len = 12 + body_len;
+    unsigned char* o = out;
+
+    *o++ = 22;
+    *o++ = 0xfe;
+    *o++ = 0xfd;
+    *o++ = 0;
+    *o++ = 0;
+    memcpy(o, ch->rec_seq, 6);
+    o += 6;
+    *o++ = (unsigned char)(rec_len >> 8);
+    *o++ = (unsigned char)rec_len;
+
+    *o++ = 2;                         /* server_hello */
+    *o++ = (unsigned char)(body_len >> 16);
+    *o++ = (unsigned char)(body_len >> 8);
+    *o++ = (unsigned char)body_len;
+    *o++ = ch->msg_seq[0];
+    *o++ = ch->msg_seq[1];
+    memset(o, 0, 3);
+    o += 3;
+    *o++ = (unsigned char)(body_len >> 16);
+    *o++ = (unsigned char)(body_len >> 8);
+    *o++ = (unsigned char)body_len;
+
+    *o++ = 0xfe;
+    *o++ = 0xfd;
+    memcpy(o, g_hrr_random, sizeof(g_hrr_random));
+    o += sizeof(g_hrr_random);
+    *o++ = (unsigned char)ch->sid_len;
+    memcpy(o, ch->sid, ch->sid_len);
+    o += ch->sid_len;
+    *o++ = suite[0];
+    *o++ = suite[1];
+    *o++ = 0;
+    *o++ = (unsigned char)(ext_len >> 8);
+    *o++ = (unsigned char)ext_len;
+    if (group > 0) {
+        *o++ = 0;
+        *o++ = 51;
+        *o++ = 0;
+        *o++ = 2;
+        *o++ = (unsigned char)(group >> 8);
+        *o++ = (unsigned char)group;
+    }
+    *o++ = 0;
+    *o++ = 43;
+    *o++ = 0;
+    *o++ = 2;
+    *o++ = 0xfe;
+    *o++ = 0xfc;
+    *o++ = 0;
+    *o++ = 44;
+    *o++ = (unsigned char)((n + 2) >> 8);
+    *o++ = (unsigned char)(n + 2);
+    *o++ = (unsigned char)(n >> 8);
+    *o++ = (unsigned char)n;
+    memcpy(o, cookie, n);
+    o += n;
+
+    fleet_stage_tx(f, (const char*)out, (int)(o - out), from);
+    return 1;
+}
+
+/* Index of the cookie secret that issued this ClientHello's cookie to
+ * this address, or -1. */
+static int cookie_check(fleet_t* f, const struct sockaddr_in* from, const fleet_ch_t* ch)
+{
+    unsigned int hash_len = ch->cookie[0];
+    if (ch->cookie_len < WC_SHA256_DIGEST_SIZE + 1 + hash_len + 2)
+        return -1;
+    unsigned int data_len = ch->cookie_len - WC_SHA256_DIGEST_SIZE;
+    if (data_len != 1 + hash_len + 2 && data_len != 1 + hash_len + 4)
+        return -1;
+
+    unsigned char mac[WC_SHA256_DIGEST_SIZE];
+    int cur = (int)(f->cookie_gen & 1);
+    for (int k = 0; k < 2; k++) {
+        int key = k == 0 ? cur : cur ^ 1;
+        cookie_mac(&f->cookie_mac[key], ch->cookie, data_len, from, mac);
+        unsigned char diff = 0;
+        for (unsigned int i = 0; i < sizeof(mac); i++)
+            diff |= mac[i] ^ ch->cookie[data_len + i];
+        if (diff == 0)
+            return key;
+    }
+    return -1;
+}
+
+static void fleet_listen(fleet_t* f, const struct sockaddr_in* from,
+                         const unsigned char* data, int len)
+{
+    char who[32];
+    fleet_ch_t ch;
+
+    /* Only a plaintext ClientHello can start a connection. */
+    int parsed = ch_parse(data, len, &ch);
+    if (parsed < 0 || f->count >= FLEET_MAX_SESSIONS) {
+        STAT_ADD(f->dropped, 1);
+        return;
+    }
+
+    /* First ClientHellos are answered here without touching wolfSSL;
+     * cookies are checked before the listener sees them, so only a
+     * returning peer costs a full ClientHello parse. While few handshakes
+     * are in progress, a ClientHello whose key share we accept skips the
+     * cookie round trip (RFC 9147 5.1 leaves the exchange to the server);
+     * under load every peer proves its address first again. */
+    int key = (int)(f->cookie_gen & 1);
+    int skip = 0;
+    if (parsed > 0 && ch.cookie == NULL) {
+        skip = f->handshaking < g_cfg.cookie_skip && ch.dtls13 && ch_hrr_group(&ch) == 0;
+        long long start_us = now_us();
+        if (!skip && cookie_reply(f, from, &ch)) {
+            STAT_ADD(f->cookies_sent, 1);
+            hist_observe(&f->hist_cookie, now_us() - start_us);
+            return;
+        }
+    }
+    else if (parsed > 0) {
+        key = cookie_check(f, from, &ch);
+        if (key < 0) {
+            STAT_ADD(f->cookie_rejects, 1);
+            return;
+        }
+    }
+
+    if (f->listener == NULL) {
+        f->listener = session_new(f);
+        if (f->listener == NULL) {
+            STAT_ADD(f->dropped, 1);
+            return;
+        }
+    }
+
+    fleet_session_t* s = f->listener;
+    s->peer = *from;
+    wolfSSL_dtls_set_peer(s->ssl, (void*)from, sizeof(*from));
+    if (skip)
+        wolfSSL_disable_hrr_cookie(s->ssl);
+    else
+        wolfSSL_send_hrr_cookie(s->ssl, f->cookie_secret[key], FLEET_COOKIE_SECRET);
+    s->rxq_head = 0;
+    s->rxq_count = 1;
+    s->rxq[0].data = data;
+    s->rxq[0].len = len;
+    s->rxq[0].from = *from;
+    long long start_us = now_us();
+    int ret = wolfDTLS_accept_stateless(s->ssl);
+    s->rxq_count = 0;
+    hist_observe(&f->hist_cookie, now_us() - start_us);
+
+    if (ret == WOLFSSL_SUCCESS) {
+        /* Cookie verified: this listener becomes the peer's session. */
+        f->listener = NULL;
+        STAT_ADD(f->count, 1);
+        f->handshaking++;
+        if (skip)
+            STAT_ADD(f->cookies_skipped, 1);
+        s->last_rx_ms = s->born_ms = now_ms();
+        s->hs_start_us = now_us();
+        s->rx_datagrams = 1;
+        s->rx_bytes = (unsigned long long)len;
+        s->ch_seq = get16(ch.msg_seq);
+        addr_link(f, s);
+        cid_link(f, s);
+        if (!f->quiet)
+            printf("[Session] %s %s, session created, %d active\n",
+                   peer_str(from, who, sizeof(who)), skip ? "key share accepted" : "cookie ok",
+                   f->count);
+        session_drive(f, s);
+    }
+    else if (ret == WOLFSSL_FAILURE) {
+        STAT_ADD(f->cookies_sent, 1);
+    }
+    else {
+        /* Garbage or a bad cookie; start over with a fresh listener. */
+        wolfSSL_free(s->ssl);
+        free(s);
+        f->listener = NULL;
+        STAT_ADD(f->dropped, 1);
+    }
+}
+
+#ifdef WOLFSSL_DTLS_CID
+/* Queue a datagram for the worker that owns its CID and wake it up. */
+static void fleet_handoff(fleet_t* owner, const struct sockaddr_in* from,
+                          const unsigned char* data, int len)
+{
+    fleet_inbox_t* in = &owner->inbox;
+    int wake = 0;
+
+    pthread_mutex_lock(&in->lock);
+    if (in->count < FLEET_INBOX && len <= FLEET_DGRAM_MAX) {
+        int i = (in->head + in->count) % FLEET_INBOX;
+        in->slot[i].from = *from;
+        in->slot[i].len = len;
+        memcpy(in->slot[i].data, data, (size_t)len);
+        wake = in->count++ == 0;
+    }
+    pthread_mutex_unlock(&in->lock);
+
+    if (wake) {
+        uint64_t one = 1;
+        if (write(in->efd, &one, sizeof(one)) < 0)
+            perror("[Worker] eventfd");
+    }
+}
+#endif
+
+/* A ClientHello older than the one that created a session: the first
+ * ClientHello, retransmitted or reordered behind the one that carried the
+ * cookie. Given to wolfSSL it would restart the handshake without the
+ * cookie and fail it. */
+static int ch_stale(const fleet_session_t* s, const unsigned char* p, int len)
+{
+    return !s->handshake_done && len >= 13 + 12 && p[0] == 22 &&
+           get16(p + 3) == 0 && p[13] == 1 && get16(p + 13 + 4) < s->ch_seq;
+}
+
+/* Route one datagram: stage it on its session, or hand it to the listener. */
+static void fleet_dispatch(fleet_t* f, const struct sockaddr_in* from,
+                           const unsigned char* data, int len, long long now)
+{
+    fleet_session_t* s = NULL;
+
+#ifdef WOLFSSL_DTLS_CID
+    const unsigned char* cid = wolfSSL_dtls_cid_parse(data, (unsigned int)len,
+                                                      FLEET_CID_LEN);
+    if (cid != NULL) {
+        if (cid[0] != f->id && cid[0] < f->nworkers) {
+            fleet_handoff(f->workers[cid[0]], from, data, len);
+            STAT_ADD(f->handoffs, 1);
+            return;
+        }
+        s = find_by_cid(f, cid);
+    }
+#endif
+    if (s == NULL)
+        s = find_by_addr(f, from);
+    if (s == NULL) {
+        fleet_listen(f, from, data, len);
+        return;
+    }
+    if (ch_stale(s, data, len)) {
+        STAT_ADD(f->dropped, 1);
+        return;
+    }
+    s->rx_datagrams++;
+    s->rx_bytes += (unsigned long long)len;
+
+    if (f->offload && (s->busy || !s->handshake_done)) {
+        /* The handshake runs on a crypto thread; it needs its own copy. */
+        fleet_copy_t* c = NULL;
+        if (s->backlog_count < FLEET_RXQ)
+            c = (fleet_copy_t*)malloc(sizeof(*c) + (size_t)len);
+        if (c == NULL) {
+            STAT_ADD(f->dropped, 1);
+            return;
+        }
+        c->next = NULL;
+        c->from = *from;
+        c->len = len;
+        memcpy(c->data, data, (size_t)len);
+        if (s->backlog_tail != NULL)
+            s->backlog_tail->next = c;
+        else
+            s->backlog = c;
+        s->backlog_tail = c;
+        s->backlog_count++;
+        s->last_rx_ms = now;
+        if (!s->busy && !s->ready) {
+            s->ready = 1;
+            s->ready_next = f->ready;
+            f->ready = s;
+        }
+        return;
+    }
+
+    if (s->rxq_count == FLEET_RXQ) {
+        STAT_ADD(f->dropped, 1);
+        return;
+    }
+    fleet_dgram_t* d = &s->rxq[(s->rxq_head + s->rxq_count) % FLEET_RXQ];
+    d->data = data;
+    d->len = len;
+    d->from = *from;
+    s->rxq_count++;
+    s->last_rx_ms = now;
+    if (!s->ready) {
+        s->ready = 1;
+        s->ready_next = f->ready;
+        f->ready = s;
+    }
+}
+
+/* Stage the first n datagrams of the receive batch, drive every touched
+ * session once and flush the replies. */
+static void fleet_process(fleet_t* f, int n)
+{
+    long long now = now_ms();
+    for (int i = 0; i < n; i++) {
+        if (f->rx.msgs[i].msg_hdr.msg_namelen != sizeof(struct sockaddr_in) ||
+            f->rx.addr[i].sin_family != AF_INET)
+            continue;
+        fleet_dispatch(f, &f->rx.addr[i], f->rx.buf[i], (int)f->rx.msgs[i].msg_len, now);
+    }
+
+    while (f->ready != NULL) {
+        fleet_session_t* s = f->ready;
+        f->ready = s->ready_next;
+        s->ready = 0;
+        if (session_drive(f, s) == 0) {
+            /* Anything wolfSSL did not pull belongs to a buffer that the
+             * next recvmmsg() overwrites. */
+            s->rxq_count = 0;
+            session_track_peer(f, s);
+            session_account(f, s);
+        }
+    }
+    fleet_flush(f);
+}
+
+/* One receive batch; returns the number of datagrams received. */
+static int fleet_rx_batch(fleet_t* f)
+{
+    for (int i = 0; i < f->batch; i++)
+        f->rx.msgs[i].msg_hdr.msg_namelen = sizeof(f->rx.addr[i]);
+
+    int n = recvmmsg(f->sock, f->rx.msgs, (unsigned int)f->batch, MSG_DONTWAIT, NULL);
+    STAT_ADD(f->rx_calls, 1);
+    if (n <= 0)
+        return 0;
+    unsigned long long bytes = 0;
+    for (int i = 0; i < n; i++)
+        bytes += f->rx.msgs[i].msg_len;
+    STAT_ADD(f->rx_datagrams, (unsigned long)n);
+    STAT_ADD(f->rx_bytes, bytes);
+    fleet_process(f, n);
+    return n;
+}
+
+/* A crypto job came back: account for it, then either send the next
+ * handshake step or, once established, serve the backlog inline. */
+static void fleet_complete(fleet_t* f, fleet_session_t* s)
+{
+    s->busy = 0;
+    copies_free(s->jobq);
+    s->jobq = NULL;
+    if (session_handshake_done(f, s, s->job_ret) < 0)
+        return;
+    session_track_peer(f, s);
+    session_account(f, s);
+
+    if (!s->handshake_done) {
+        if (s->backlog != NULL)
+            session_submit(f, s);
+        return;
+    }
+    s->jobq = s->backlog;
+    s->backlog = s->backlog_tail = NULL;
+    s->backlog_count = 0;
+    if (session_drive(f, s) == 0) {
+        copies_free(s->jobq);
+        s->jobq = NULL;
+        session_track_peer(f, s);
+        session_account(f, s);
+    }
+}
+
+/* Feed datagrams handed off by other workers through the same path, and
+ * pick up finished crypto jobs. */
+static void fleet_drain_inbox(fleet_t* f)
+{
+    fleet_inbox_t* in = &f->inbox;
+    uint64_t cnt;
+    if (read(in->efd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN)
+        perror("[Worker] eventfd");
+
+    pthread_mutex_lock(&in->lock);
+    fleet_session_t* done = f->done;
+    f->done = NULL;
+    pthread_mutex_unlock(&in->lock);
+    while (done != NULL) {
+        fleet_session_t* s = done;
+        done = s->job_next;
+        fleet_complete(f, s);
+    }
+    fleet_flush(f);
+
+    for (;;) {
+        int n = 0;
+        pthread_mutex_lock(&in->lock);
+        while (in->count > 0 && n < f->batch) {
+            f->rx.addr[n] = in->slot[in->head].from;
+            f->rx.msgs[n].msg_hdr.msg_namelen = sizeof(f->rx.addr[n]);
+            f->rx.msgs[n].msg_len = (unsigned int)in->slot[in->head].len;
+            memcpy(f->rx.buf[n], in->slot[in->head].data, (size_t)in->slot[in->head].len);
+            in->head = (in->head + 1) % FLEET_INBOX;
+            in->count--;
+            n++;
+        }
+        pthread_mutex_unlock(&in->lock);
+        if (n == 0)
+            break;
+        fleet_process(f, n);
+    }
+}
+
+/* Fire expired retransmission timers and reap idle peers; returns the
+ * number of milliseconds until the next timer. */
+static long long fleet_timers(fleet_t* f)
+{
+    long long now = now_ms();
+    long long next = 1000;
+
+    cookie_refresh(f, now);
+
+    for (int b = 0; b < FLEET_HASH_BUCKETS; b++) {
+        fleet_session_t* s = f->by_addr[b];
+        while (s != NULL) {
+            fleet_session_t* nx = s->addr_next;
+            if (s->busy) {
+                s = nx;
+                continue;
+            }
+            if (now - s->last_rx_ms > FLEET_IDLE_TIMEOUT_S * 1000LL) {
+                session_free(f, s, "idle");
+                s = nx;
+                continue;
+            }
+            if (s->deadline_ms != 0 && now >= s->deadline_ms) {
+                s->retransmits++;
+                STAT_ADD(f->retransmits, 1);
+                if (wolfSSL_dtls_got_timeout(s->ssl) == WOLFSSL_FATAL_ERROR) {
+                    session_free(f, s, "retransmit limit");
+                    s = nx;
+                    continue;
+                }
+                session_arm_timer(s);
+            }
+            if (s->deadline_ms != 0 && s->deadline_ms - now < next)
+                next = s->deadline_ms > now ? s->deadline_ms - now : 0;
+            s = nx;
+        }
+    }
+    return next;
+}
+
+#ifndef NO_PSK
+static unsigned int psk_server_cb(WOLFSSL* ssl, const char* identity,
+                                  unsigned char* key, unsigned int key_max_len)
+{
+    (void)ssl;
+    if (identity == NULL || strcmp(identity, g_cfg.psk_identity) != 0) {
+        if (!g_cfg.quiet)
+            printf("[PSK] ✗ Unknown identity '%s'\n", identity != NULL ? identity : "");
+        return 0;
+    }
+    if (key_max_len < g_cfg.psk_len)
+        return 0;
+    memcpy(key, g_cfg.psk_key, g_cfg.psk_len);
+    return g_cfg.psk_len;
+}
+#endif
+
+#ifdef HAVE_CERT_COMPRESSION
+/* DER of the CA, the dictionary for CompressedCertificate. The devices hold
+ * the same CA, so the codepoint derived from it matches on both ends. */
+static unsigned char g_cert_dict[4096];
+static word32 g_cert_dict_len;
+
+static int cert_dict_load(const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "[Init] ✗ cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    unsigned char pem[8192];
+    size_t n = fread(pem, 1, sizeof(pem), fp);
+    fclose(fp);
+    if (n == 0 || n == sizeof(pem)) {
+        fprintf(stderr, "[Init] ✗ %s is empty or too large\n", path);
+        return -1;
+    }
+    int der = wc_CertPemToDer(pem, (int)n, g_cert_dict, (int)sizeof(g_cert_dict), CERT_TYPE);
+    if (der <= 0) {
+        fprintf(stderr, "[Init] ✗ %s holds no PEM certificate\n", path);
+        return -1;
+    }
+    g_cert_dict_len = (word32)der;
+    return 0;
+}
+#endif
+
+static int fleet_ctx_certs(WOLFSSL_CTX* ctx, int verbose)
+{
+    if (verbose)
+        printf("[Init] Loading CA certificate: %s\n", g_cfg.ca_file);
+    if (wolfSSL_CTX_load_verify_locations(ctx, g_cfg.ca_file, NULL) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Failed to load CA certificate\n");
+        return -1;
+    }
+    if (verbose)
+        printf("[Init] Loading server certificate: %s\n", g_cfg.cert_file);
+    if (wolfSSL_CTX_use_certificate_file(ctx, g_cfg.cert_file, WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Failed to load server certificate\n");
+        return -1;
+    }
+    if (verbose)
+        printf("[Init] Loading server private key: %s\n", g_cfg.key_file);
+    if (wolfSSL_CTX_use_PrivateKey_file(ctx, g_cfg.key_file, WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Failed to load server private key\n");
+        return -1;
+    }
+#ifdef HAVE_CERT_COMPRESSION
+    if (g_cert_dict_len > 0 &&
+        wolfSSL_CTX_set_cert_compress_dict(ctx, g_cert_dict, g_cert_dict_len) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Certificate compression dictionary rejected\n");
+        return -1;
+    }
+#endif
+    if (g_cfg.verify_peer)
+        wolfSSL_CTX_set_verify(ctx, WOLFSSL_VERIFY_PEER | WOLFSSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+    else
+        wolfSSL_CTX_set_verify(ctx, WOLFSSL_VERIFY_NONE, NULL);
+    return 0;
+}
+
+#ifdef WOLFSSL_HAVE_RPK_PIN
+/* Raw public keys as DER SubjectPublicKeyInfo, read once at startup and
+ * handed to each worker's CTX: ours in g_rpk, the device allow-list in
+ * g_rpk_allow as u16 length | key entries. */
+static unsigned char g_rpk[1024];
+static word32 g_rpk_len;
+static unsigned char* g_rpk_allow;
+static word32 g_rpk_allow_len;
+static int g_rpk_allow_cnt;
+
+/* Every "PUBLIC KEY" PEM block of path, as u16 length | DER entries. */
+static int rpk_pem_load(const char* path, unsigned char** out, word32* out_len, int* cnt)
+{
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "[Init] ✗ cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    char* pem = NULL;
+    if (fstat(fileno(fp), &st) == 0 && st.st_size > 0)
+        pem = malloc((size_t)st.st_size + 1);
+    size_t n = pem != NULL ? fread(pem, 1, (size_t)st.st_size, fp) : 0;
+    fclose(fp);
+    if (n == 0) {
+        fprintf(stderr, "[Init] ✗ cannot read %s\n", path);
+        free(pem);
+        return -1;
+    }
+    pem[n] = '\0';
+
+    /* DER is shorter than its base64, so the PEM size bounds the output. */
+    unsigned char* der = malloc(n);
+    word32 len = 0;
+    int rc = 0;
+    *cnt = 0;
+    static const char end_tag[] = "-----END PUBLIC KEY-----";
+    for (char* p = strstr(pem, "-----BEGIN PUBLIC KEY-----"); der != NULL && p != NULL;
+         p = strstr(p, "-----BEGIN PUBLIC KEY-----")) {
+        char* e = strstr(p, end_tag);
+        if (e == NULL) {
+            rc = -1;
+            break;
+        }
+        e += sizeof(end_tag) - 1;
+        DerBuffer* key = NULL;
+        if (wc_PemToDer((const unsigned char*)p, (long)(e - p), PUBLICKEY_TYPE, &key, NULL, NULL, NULL) != 0 ||
+            key == NULL || key->length > 0xffff || len + 2 + key->length > n) {
+            wc_FreeDer(&key);
+            rc = -1;
+            break;
+        }
+        /* u16 length | SubjectPublicKeyInfo */
+        der[len] = (unsigned char)(key->length >> 8);
+        der[len + 1] = (unsigned char)key->length;
+        memcpy(der + len + 2, key->buffer, key->length);
+        len += 2 + key->length;
+        (*cnt)++;
+        wc_FreeDer(&key);
+        p = e;
+    }
+    free(pem);
+    if (der == NULL || rc != 0 || *cnt == 0) {
+        fprintf(stderr, "[Init] ✗ %s holds no usable PEM public key\n", path);
+        free(der);
+        return -1;
+    }
+    *out = der;
+    *out_len = len;
+    return 0;
+}
+
+/* Our own key is loaded as the "certificate"; the wolfSSL RPK support
+ * recognises a bare SubjectPublicKeyInfo and sends it as such. */
+static int rpk_load(void)
+{
+    unsigned char* own = NULL;
+    word32 own_len = 0;
+    int cnt = 0;
+    if (rpk_pem_load(g_cfg.rpk_file, &own, &own_len, &cnt) != 0)
+        return -1;
+    if (cnt != 1 || own_len - 2 > sizeof(g_rpk)) {
+        fprintf(stderr, "[Init] ✗ %s must hold exactly one public key\n", g_cfg.rpk_file);
+        free(own);
+        return -1;
+    }
+    g_rpk_len = own_len - 2;
+    memcpy(g_rpk, own + 2, g_rpk_len);
+    free(own);
+    return rpk_pem_load(g_cfg.rpk_allow_file, &g_rpk_allow, &g_rpk_allow_len, &g_rpk_allow_cnt);
+}
+
+static int fleet_ctx_rpk(WOLFSSL_CTX* ctx, int verbose)
+{
+    static const char rpk_only[] = { WOLFSSL_CERT_TYPE_RPK };
+    if (wolfSSL_CTX_set_server_cert_type(ctx, rpk_only, 1) != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_set_client_cert_type(ctx, rpk_only, 1) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Raw public key certificate type rejected\n");
+        return -1;
+    }
+    if (verbose)
+        printf("[Init] Loading server raw public key: %s\n", g_cfg.rpk_file);
+    if (wolfSSL_CTX_use_certificate_buffer(ctx, g_rpk, (long)g_rpk_len,
+                                           WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Failed to load server raw public key\n");
+        return -1;
+    }
+    if (verbose)
+        printf("[Init] Loading server private key: %s\n", g_cfg.key_file);
+    if (wolfSSL_CTX_use_PrivateKey_file(ctx, g_cfg.key_file, WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Failed to load server private key\n");
+        return -1;
+    }
+    for (word32 i = 0; i < g_rpk_allow_len; ) {
+        int len = (g_rpk_allow[i] << 8) | g_rpk_allow[i + 1];
+        if (wolfSSL_CTX_add_rpk_pin(ctx, g_rpk_allow + i + 2, len) != WOLFSSL_SUCCESS) {
+            fprintf(stderr, "[Init] ✗ Device allow-list rejected\n");
+            return -1;
+        }
+        i += 2 + (word32)len;
+    }
+    /* Devices are authenticated by being on the allow-list; there is no
+     * chain to verify. */
+    if (g_cfg.verify_peer)
+        wolfSSL_CTX_set_verify(ctx, WOLFSSL_VERIFY_PEER | WOLFSSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+    else
+        wolfSSL_CTX_set_verify(ctx, WOLFSSL_VERIFY_NONE, NULL);
+    return 0;
+}
+#endif
+
+static WOLFSSL_CTX* fleet_ctx_new(int verbose)
+{
+    WOLFSSL_CTX* ctx = wolfSSL_CTX_new(wolfDTLSv1_3_server_method());
+    if (ctx == NULL) {
+        fprintf(stderr, "[Init] ✗ wolfSSL_CTX_new failed\n");
+        return NULL;
+    }
+
+    if (g_cfg.auth == FLEET_AUTH_PSK) {
+#ifndef NO_PSK
+        if (verbose)
+            printf("[Init] PSK authentication, identity '%s'\n", g_cfg.psk_identity);
+        wolfSSL_CTX_set_psk_server_callback(ctx, psk_server_cb);
+#else
+        fprintf(stderr, "[Init] ✗ auth psk needs a wolfSSL built without NO_PSK\n");
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+#endif
+    }
+    else if (g_cfg.auth == FLEET_AUTH_RPK) {
+#ifdef WOLFSSL_HAVE_RPK_PIN
+        if (fleet_ctx_rpk(ctx, verbose) != 0) {
+            wolfSSL_CTX_free(ctx);
+            return NULL;
+        }
+#else
+        fprintf(stderr, "[Init] ✗ auth rpk needs the wolfSSL from boot/src (wolfSSL_CTX_add_rpk_pin)\n");
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+#endif
+    }
+    else if (fleet_ctx_certs(ctx, verbose) != 0) {
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+    }
+
+    if (wolfSSL_CTX_set_cipher_list(ctx, g_cfg.ciphers) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ No usable cipher suite in '%s'\n", g_cfg.ciphers);
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+    }
+    if (g_cfg.ngroups > 0 &&
+        wolfSSL_CTX_set_groups(ctx, g_cfg.groups, g_cfg.ngroups) != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "[Init] ✗ Key exchange group selection rejected\n");
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+    }
+    wolfSSL_CTX_set_options(ctx, WOLFSSL_OP_NO_QUERY_MTU);
+    if (g_cfg.group_messages)
+        wolfSSL_CTX_set_group_messages(ctx);
+    wolfSSL_SetIORecv(ctx, bio_recv);
+    wolfSSL_SetIOSend(ctx, bio_send);
+#ifdef FLEET_SHM_CACHE
+    if (g_shm != NULL) {
+        /* Stateful tickets: the ticket is just the ID of a shared entry. */
+        wolfSSL_CTX_set_options(ctx, WOLFSSL_OP_NO_TICKET);
+        wolfSSL_CTX_set_session_cache_mode(ctx, WOLFSSL_SESS_CACHE_NO_INTERNAL);
+        wolfSSL_CTX_sess_set_new_cb(ctx, shm_sess_new);
+        wolfSSL_CTX_sess_set_get_cb(ctx, shm_sess_get);
+        wolfSSL_CTX_set_TicketHint(ctx, FLEET_SHM_LIFETIME);
+        return ctx;
+    }
+#endif
+#ifdef HAVE_SESSION_TICKET
+    if (g_tickets.rotate_s > 0) {
+        wolfSSL_CTX_set_TicketEncCb(ctx, ticket_enc_cb);
+        wolfSSL_CTX_set_TicketHint(ctx, ticket_lifetime_s());
+    }
+    else {
+        wolfSSL_CTX_no_ticket_TLSv13(ctx);
+    }
+#endif
+    return ctx;
+}
+
+/* Socket, context, epoll set and inbox for one worker. */
+static int fleet_worker_init(fleet_t* f, const struct sockaddr_in* addr)
+{
+    batch_init(&f->rx);
+    batch_init(&f->tx);
+    f->sock = f->epfd = f->inbox.efd = -1;
+
+    f->sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (f->sock < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    int one = 1;
+    if (setsockopt(f->sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0 ||
+        setsockopt(f->sock, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+        perror("setsockopt");
+        return -1;
+    }
+    if (bind(f->sock, (const struct sockaddr*)addr, sizeof(*addr)) < 0) {
+        perror("bind");
+        return -1;
+    }
+
+    /* A reconnecting fleet arrives in bursts; give the kernel room to queue
+     * them between batches (best effort, capped by net.core.rmem_max). */
+    int sockbuf = 4 * 1024 * 1024;
+    setsockopt(f->sock, SOL_SOCKET, SO_RCVBUF, &sockbuf, sizeof(sockbuf));
+    setsockopt(f->sock, SOL_SOCKET, SO_SNDBUF, &sockbuf, sizeof(sockbuf));
+
+    pthread_mutex_init(&f->inbox.lock, NULL);
+    f->inbox.efd = eventfd(0, EFD_NONBLOCK);
+    f->epfd = epoll_create1(0);
+    if (f->inbox.efd < 0 || f->epfd < 0) {
+        perror("epoll");
+        return -1;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = f->sock;
+    if (epoll_ctl(f->epfd, EPOLL_CTL_ADD, f->sock, &ev) < 0) {
+        perror("epoll_ctl");
+        return -1;
+    }
+    ev.data.fd = f->inbox.efd;
+    if (epoll_ctl(f->epfd, EPOLL_CTL_ADD, f->inbox.efd, &ev) < 0) {
+        perror("epoll_ctl");
+        return -1;
+    }
+
+    cookie_refresh(f, now_ms());
+    if (wc_InitRng(&f->rng) != 0) {
+        fprintf(stderr, "[Init] ✗ wc_InitRng failed\n");
+        return -1;
+    }
+    f->ctx = fleet_ctx_new(f->id == 0);
+    return f->ctx != NULL ? 0 : -1;
+}
+
+static void fleet_worker_cleanup(fleet_t* f)
+{
+    for (int b = 0; b < FLEET_HASH_BUCKETS; b++) {
+        while (f->by_addr[b] != NULL)
+            session_free(f, f->by_addr[b], NULL);
+    }
+    if (f->listener != NULL) {
+        wolfSSL_free(f->listener->ssl);
+        free(f->listener);
+        f->listener = NULL;
+    }
+    fleet_flush(f);
+    if (f->ctx != NULL)
+        wolfSSL_CTX_free(f->ctx);
+    wc_FreeRng(&f->rng);
+    if (f->epfd >= 0)
+        close(f->epfd);
+    if (f->inbox.efd >= 0)
+        close(f->inbox.efd);
+    if (f->sock >= 0)
+        close(f->sock);
+    pthread_mutex_destroy(&f->inbox.lock);
+}
+
+static void* fleet_worker_run(void* arg)
+{
+    fleet_t* f = (fleet_t*)arg;
+
+    while (!g_stop) {
+        long long wait_ms = fleet_timers(f);
+        fleet_flush(f);
+
+        struct epoll_event events[2];
+        int n = epoll_wait(f->epfd, events, 2, (int)wait_ms);
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.fd == f->inbox.efd) {
+                fleet_drain_inbox(f);
+                continue;
+            }
+            /* Drain the socket; a short batch means it is empty. */
+            while (fleet_rx_batch(f) == f->batch && !g_stop)
+                ;
+        }
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Metrics endpoint                                                         */
+/* ------------------------------------------------------------------------ */
+
+static struct {
+    int sock;
+    int nworkers;
+    fleet_t** workers;
+    pthread_t tid;
+} g_metrics = { -1, 0, NULL, 0 };
+
+static void metrics_counter(FILE* out, const char* name, const char* help)
+{
+    fprintf(out, "# HELP dtls_fleet_%s %s\n# TYPE dtls_fleet_%s counter\n", name, help, name);
+}
+
+static void metrics_hist(FILE* out, const char* phase, int worker, const fleet_hist_t* h)
+{
+    unsigned long long cum = 0;
+    for (int i = 0; i <= FLEET_HIST_BUCKETS; i++) {
+        cum += STAT_GET(h->bucket[i]);
+        if (i < FLEET_HIST_BUCKETS)
+            fprintf(out, "dtls_fleet_handshake_phase_seconds_bucket{worker=\"%d\",phase=\"%s\","
+                         "le=\"%g\"} %llu\n", worker, phase, (double)g_hist_le_us[i] / 1e6, cum);
+        else
+            fprintf(out, "dtls_fleet_handshake_phase_seconds_bucket{worker=\"%d\",phase=\"%s\","
+                         "le=\"+Inf\"} %llu\n", worker, phase, cum);
+    }
+    fprintf(out, "dtls_fleet_handshake_phase_seconds_sum{worker=\"%d\",phase=\"%s\"} %.6f\n",
+            worker, phase, (double)STAT_GET(h->sum_us) / 1e6);
+    fprintf(out, "dtls_fleet_handshake_phase_seconds_count{worker=\"%d\",phase=\"%s\"} %llu\n",
+            worker, phase, STAT_GET(h->count));
+}
+
+/* Render every worker's counters in the Prometheus text format. */
+static void metrics_render(FILE* out)
+{
+    fleet_t** w = g_metrics.workers;
+    int n = g_metrics.nworkers;
+
+#define PER_WORKER(fmt_labels, expr) \
+    for (int i = 0; i < n; i++) \
+        fprintf(out, "%s{worker=\"%d\"" fmt_labels "} %llu\n", metric, i, \
+                (unsigned long long)(expr))
+
+    const char* metric;
+
+    metrics_counter(out, "handshakes_total", "Completed handshakes by kind.");
+    metric = "dtls_fleet_handshakes_total";
+    PER_WORKER(",kind=\"resumed\"", STAT_GET(w[i]->resumed));
+    PER_WORKER(",kind=\"full\"", STAT_GET(w[i]->handshakes) - STAT_GET(w[i]->resumed));
+
+    metrics_counter(out, "handshake_cpu_seconds_total", "CPU time spent in wolfSSL_accept by kind.");
+    for (int i = 0; i < n; i++) {
+        fprintf(out, "dtls_fleet_handshake_cpu_seconds_total{worker=\"%d\",kind=\"resumed\"} %.6f\n",
+                i, (double)STAT_GET(w[i]->resumed_cpu_ns) / 1e9);
+        fprintf(out, "dtls_fleet_handshake_cpu_seconds_total{worker=\"%d\",kind=\"full\"} %.6f\n",
+                i, (double)STAT_GET(w[i]->full_cpu_ns) / 1e9);
+    }
+
+    metrics_counter(out, "handshake_failures_total", "Handshakes that ended in an error.");
+    metric = "dtls_fleet_handshake_failures_total";
+    PER_WORKER("", STAT_GET(w[i]->hs_failures));
+
+    metrics_counter(out, "cookies_sent_total", "Stateless HelloRetryRequest cookies sent.");
+    metric = "dtls_fleet_cookies_sent_total";
+    PER_WORKER("", STAT_GET(w[i]->cookies_sent));
+    metrics_counter(out, "cookies_skipped_total",
+                    "First ClientHellos with an acceptable key share answered without a cookie.");
+    metric = "dtls_fleet_cookies_skipped_total";
+    PER_WORKER("", STAT_GET(w[i]->cookies_skipped));
+    metrics_counter(out, "cookie_rejects_total", "ClientHellos dropped for a bad or expired cookie.");
+    metric = "dtls_fleet_cookie_rejects_total";
+    PER_WORKER("", STAT_GET(w[i]->cookie_rejects));
+
+    metrics_counter(out, "retransmit_timeouts_total", "Handshake flights retransmitted on timer.");
+    metric = "dtls_fleet_retransmit_timeouts_total";
+    PER_WORKER("", STAT_GET(w[i]->retransmits));
+
+    metrics_counter(out, "aead_failures_total", "Records dropped for failing AEAD decryption.");
+    metric = "dtls_fleet_aead_failures_total";
+    PER_WORKER("", STAT_GET(w[i]->aead_failures));
+
+    metrics_counter(out, "replay_drops_total", "Records dropped by the replay window.");
+    metric = "dtls_fleet_replay_drops_total";
+    PER_WORKER("", STAT_GET(w[i]->replay_drops));
+
+    metrics_counter(out, "datagrams_total", "UDP datagrams by direction.");
+    metric = "dtls_fleet_datagrams_total";
+    PER_WORKER(",dir=\"rx\"", STAT_GET(w[i]->rx_datagrams));
+    PER_WORKER(",dir=\"tx\"", STAT_GET(w[i]->tx_datagrams) + STAT_GET(w[i]->tx_direct));
+
+    metrics_counter(out, "bytes_total", "UDP payload bytes by direction.");
+    metric = "dtls_fleet_bytes_total";
+    PER_WORKER(",dir=\"rx\"", STAT_GET(w[i]->rx_bytes));
+    PER_WORKER(",dir=\"tx\"", STAT_GET(w[i]->tx_bytes) + STAT_GET(w[i]->tx_direct_bytes));
+
+    metrics_counter(out, "syscalls_total", "Socket system calls.");
+    metric = "dtls_fleet_syscalls_total";
+    PER_WORKER(",call=\"recvmmsg\"", STAT_GET(w[i]->rx_calls));
+    PER_WORKER(",call=\"sendmmsg\"", STAT_GET(w[i]->tx_calls) + STAT_GET(w[i]->tx_direct));
+
+    metrics_counter(out, "dropped_datagrams_total", "Datagrams dropped by the server (queues full, garbage).");
+    metric = "dtls_fleet_dropped_datagrams_total";
+    PER_WORKER("", STAT_GET(w[i]->dropped));
+
+    metrics_counter(out, "handoffs_total", "CID datagrams handed to their owning worker.");
+    metric = "dtls_fleet_handoffs_total";
+    PER_WORKER("", STAT_GET(w[i]->handoffs));
+
+    fprintf(out, "# HELP dtls_fleet_active_sessions Sessions past the cookie exchange.\n"
+                 "# TYPE dtls_fleet_active_sessions gauge\n");
+    metric = "dtls_fleet_active_sessions";
+    PER_WORKER("", STAT_GET(w[i]->count));
+#undef PER_WORKER
+
+    fprintf(out, "# HELP dtls_fleet_handshake_phase_seconds Handshake time by phase: cookie "
+                 "(one stateless ClientHello), key_exchange (ClientHello to server flight), "
+                 "cert_verify (client flight to done), total (cookie verified to done).\n"
+                 "# TYPE dtls_fleet_handshake_phase_seconds histogram\n");
+    for (int i = 0; i < n; i++) {
+        metrics_hist(out, "cookie", i, &w[i]->hist_cookie);
+        metrics_hist(out, "key_exchange", i, &w[i]->hist_kx);
+        metrics_hist(out, "cert_verify", i, &w[i]->hist_verify);
+        metrics_hist(out, "total", i, &w[i]->hist_total);
+    }
+}
+
+/* Minimal HTTP/1.0 responder: one request per connection. */
+static void* metrics_thread(void* arg)
+{
+    (void)arg;
+    while (!g_stop) {
+        struct pollfd pfd = { g_metrics.sock, POLLIN, 0 };
+        if (poll(&pfd, 1, 500) <= 0)
+            continue;
+        int c = accept(g_metrics.sock, NULL, NULL);
+        if (c < 0)
+            continue;
+
+        struct timeval tv = { 1, 0 };
+        setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        char req[1024];
+        ssize_t n = recv(c, req, sizeof(req) - 1, 0);
+        req[n > 0 ? n : 0] = '\0';
+
+        char* body = NULL;
+        size_t len = 0;
+        const char* status = "200 OK";
+        FILE* out = open_memstream(&body, &len);
+        if (out == NULL) {
+            close(c);
+            continue;
+        }
+        if (strncmp(req, "GET /metrics ", 13) == 0 || strncmp(req, "GET / ", 6) == 0) {
+            metrics_render(out);
+        }
+        else {
+            status = "404 Not Found";
+            fprintf(out, "try GET /metrics\n");
+        }
+        fclose(out);
+
+        char hdr[160];
+        int hlen = snprintf(hdr, sizeof(hdr),
+                            "HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                            "Content-Length: %zu\r\nConnection: close\r\n\r\n", status, len);
+        if (send(c, hdr, (size_t)hlen, MSG_NOSIGNAL) == hlen)
+            send(c, body, len, MSG_NOSIGNAL);
+        free(body);
+        close(c);
+    }
+    return NULL;
+}
+
+static int metrics_start(int port, fleet_t** workers, int nworkers)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int one = 1;
+    g_metrics.sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (g_metrics.sock < 0 ||
+        setsockopt(g_metrics.sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0 ||
+        bind(g_metrics.sock, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(g_metrics.sock, 8) < 0) {
+        perror("[Init] metrics listener");
+        return -1;
+    }
+    g_metrics.workers = workers;
+    g_metrics.nworkers = nworkers;
+    if (pthread_create(&g_metrics.tid, NULL, metrics_thread, NULL) != 0)
+        return -1;
+    printf("[Init] Metrics on http://127.0.0.1:%d/metrics\n", port);
+    return 0;
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [-f file] [-a auth] [-C dir] [-g groups] [-s ciphers] [-u mtu]\n"
+                    "       [-m batch] [-w workers] [-c crypto] [-T rotate] [-S name] [-M port] [-q]\n"
+                    "       [bind_ip] [port]\n"
+                    "  -f FILE  read 'key = value' settings; later options override them\n"
+                    "  -a MODE  cert (default, mutual certificate auth), rpk (raw public keys,\n"
+                    "           devices pinned by rpk-allow.pem) or psk\n"
+                    "  -C DIR   ca-cert.pem, server-cert.pem, server-key.pem, server-rpk.pem\n"
+                    "           and rpk-allow.pem (default %s)\n"
+                    "  -g LIST  key exchange groups in preference order, 'pqc' = all hybrids:\n"
+                    "          ",
+            prog, DEFAULT_CERT_DIR);
+    for (int i = 0; i < FLEET_GROUP_NAMES; i++)
+        fprintf(stderr, " %s", g_group_names[i].name);
+    fprintf(stderr, "\n"
+                    "  -s LIST  cipher suites (default %s)\n"
+                    "  -u N     DTLS MTU in bytes (default %d)\n"
+                    "  -m N     datagrams per recvmmsg/sendmmsg (1..%d, default %d)\n"
+                    "  -w N     worker threads, one SO_REUSEPORT socket each (1..%d, default 1)\n"
+                    "  -c N     crypto threads running handshakes (0..%d, default 0 = inline)\n"
+                    "  -T N     seconds between session ticket key rotations (default %d, 0 = no tickets)\n"
+                    "  -S NAME  share sessions through /dev/shm/NAME (stateful tickets)\n"
+                    "  -M PORT  Prometheus metrics on 127.0.0.1:PORT/metrics\n"
+                    "  -q       no per-session/per-message logging\n",
+            DEFAULT_CIPHERS, DTLS_MTU, FLEET_BATCH, FLEET_BATCH, FLEET_MAX_WORKERS,
+            FLEET_MAX_CRYPTO, FLEET_TICKET_ROTATE);
+}
+
+/* Command line options that set a config file key. */
+static const struct {
+    int opt;
+    const char* key;
+} g_cli_keys[] = {
+    { 'a', "auth" }, { 'C', "certs" }, { 'g', "groups" }, { 's', "ciphers" },
+    { 'u', "mtu" }, { 'm', "batch" }, { 'w', "workers" }, { 'c', "crypto" },
+    { 'T', "ticket_rotate" }, { 'S', "shm" }, { 'M', "metrics" },
+};
+
+int main(int argc, char** argv)
+{
+    static const char* optstring = "f:a:C:g:s:u:m:w:c:T:S:M:qh";
+    int opt;
+
+    /* The file first, so anything on the command line wins. */
+    while ((opt = getopt(argc, argv, optstring)) != -1) {
+        if (opt == 'f' && cfg_load(optarg) != 0)
+            return 1;
+        if (opt == '?' || opt == 'h') {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    optind = 1;
+    while ((opt = getopt(argc, argv, optstring)) != -1) {
+        int rc = 0;
+        if (opt == 'q')
+            rc = cfg_set("quiet", "yes");
+        for (size_t i = 0; i < sizeof(g_cli_keys) / sizeof(g_cli_keys[0]); i++) {
+            if (g_cli_keys[i].opt == opt)
+                rc = cfg_set(g_cli_keys[i].key, optarg);
+        }
+        if (rc != 0) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((optind < argc && cfg_set("bind", argv[optind]) != 0) ||
+        (optind + 1 < argc && cfg_set("port", argv[optind + 1]) != 0))
+        return 1;
+
+    const char* bind_ip = g_cfg.bind_ip;
+    int bind_port = g_cfg.port;
+    int nworkers = g_cfg.workers;
+    int ncrypto = g_cfg.crypto;
+    int batch = g_cfg.batch;
+    const char* shm_name = g_cfg.shm_name[0] != '\0' ? g_cfg.shm_name : NULL;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)bind_port);
+    inet_aton(bind_ip, &addr.sin_addr);
+
+    printf("\n=== DTLS 1.3 Fleet Server ===\n");
+    printf("Server listening on %s:%d\n", bind_ip, bind_port);
+    printf("Up to %d concurrent devices per worker, demux by address and %d-byte CID\n",
+           FLEET_MAX_SESSIONS, FLEET_CID_LEN);
+    printf("%d worker%s, epoll loop, %d datagram%s per syscall\n",
+           nworkers, nworkers == 1 ? "" : "s", batch, batch == 1 ? "" : "s");
+    if (ncrypto > 0)
+        printf("%d crypto thread%s for handshakes\n", ncrypto, ncrypto == 1 ? "" : "s");
+    if (g_cfg.auth == FLEET_AUTH_PSK)
+        printf("Auth: PSK, identity '%s' (%u-byte key)\n", g_cfg.psk_identity, g_cfg.psk_len);
+    else if (g_cfg.auth == FLEET_AUTH_RPK)
+        printf("Auth: raw public key %s, devices from %s\n", g_cfg.rpk_file,
+               g_cfg.rpk_allow_file);
+    else
+        printf("Auth: certificates from %s, %s\n", g_cfg.cert_file,
+               g_cfg.verify_peer ? "client certificate required" : "no client certificate");
+    printf("Ciphers: %s, groups:", g_cfg.ciphers);
+    if (g_cfg.ngroups == 0)
+        printf(" wolfSSL defaults");
+    for (int i = 0; i < g_cfg.ngroups; i++) {
+        for (int j = 0; j < FLEET_GROUP_NAMES; j++) {
+            if (g_group_names[j].group == g_cfg.groups[i])
+                printf("%s%s", i == 0 ? " " : ",", g_group_names[j].name);
+        }
+    }
+#ifndef WOLFSSL_HAVE_DTLS13_SHORT_HEADER
+    g_cfg.short_header = 0;    /* only the wolfSSL in boot/src sends them */
+#endif
+    printf(", MTU %d%s%s\n", g_cfg.mtu, g_cfg.group_messages ? ", flights grouped" : "",
+           g_cfg.short_header ? ", short app data headers" : "");
+#ifndef WOLFSSL_DTLS_MTU
+    if (g_cfg.mtu != DTLS_MTU)
+        printf("[Init] ⚠ wolfSSL built without WOLFSSL_DTLS_MTU, MTU setting ignored\n");
+#endif
+
+    printf("[Init] Initializing wolfSSL library...\n");
+    wolfSSL_Init();
+
+    /* One cookie key ring for every worker: a retried ClientHello is valid
+     * wherever the kernel steers it. */
+    if (cookie_keys_init(g_cfg.cookie_rotate) != 0) {
+        fprintf(stderr, "[Init] ✗ RNG failed\n");
+        return 1;
+    }
+    if (cookie_suites_init() == 0)
+        printf("[Init] ⚠ No cipher suite known to the cookie stage, wolfSSL answers every ClientHello\n");
+    printf("HelloRetryRequest cookies: HMAC-SHA256, key rotated every %d s\n", g_cfg.cookie_rotate);
+    if (g_cfg.cookie_skip > 0)
+        printf("No cookie for an acceptable key share while under %d handshakes per worker\n",
+               g_cfg.cookie_skip);
+
+#ifdef WOLFSSL_HAVE_RPK_PIN
+    if (g_cfg.auth == FLEET_AUTH_RPK) {
+        if (rpk_load() != 0)
+            return 1;
+        printf("Raw public keys: %u-byte server key, %d device%s allowed\n",
+               g_rpk_len, g_rpk_allow_cnt, g_rpk_allow_cnt == 1 ? "" : "s");
+    }
+#endif
+
+    if (g_cfg.cert_compress && g_cfg.auth == FLEET_AUTH_CERT) {
+#ifdef HAVE_CERT_COMPRESSION
+        if (cert_dict_load(g_cfg.ca_file) != 0)
+            return 1;
+        printf("Certificate compression: CA dictionary, %u bytes\n", g_cert_dict_len);
+#else
+        fprintf(stderr, "[Init] ✗ cert_compress needs a wolfSSL built with HAVE_CERT_COMPRESSION\n");
+        return 1;
+#endif
+    }
+
+#ifdef HAVE_SESSION_TICKET
+    int rotate = g_cfg.rotate;
+    if (rotate > 0 && shm_name == NULL) {
+        if (wc_InitRng(&g_tickets.rng) != 0) {
+            fprintf(stderr, "[Init] ✗ RNG failed\n");
+            return 1;
+        }
+        g_tickets.rotate_s = rotate;
+        printf("Session tickets: AES-256-GCM, key ring of %d, rotated every %d s\n",
+               FLEET_TICKET_KEYS, rotate);
+    }
+#endif
+    if (shm_name != NULL) {
+#ifdef FLEET_SHM_CACHE
+        if (shm_open_cache(shm_name) != 0)
+            return 1;
+#else
+        fprintf(stderr, "[Init] ✗ -S needs HAVE_EXT_CACHE and WOLFSSL_TICKET_HAVE_ID\n");
+        return 1;
+#endif
+    }
+
+    static fleet_t* workers[FLEET_MAX_WORKERS];
+    int ok = 1;
+    for (int i = 0; i < nworkers && ok; i++) {
+        fleet_t* f = (fleet_t*)calloc(1, sizeof(*f));
+        if (f == NULL) {
+            ok = 0;
+            break;
+        }
+        workers[i] = f;
+        f->id = i;
+        f->nworkers = nworkers;
+        f->workers = workers;
+        f->batch = batch;
+        f->quiet = g_cfg.quiet;
+        f->offload = ncrypto > 0;
+        ok = fleet_worker_init(f, &addr) == 0;
+    }
+    if (ok && g_cfg.metrics_port > 0)
+        ok = metrics_start(g_cfg.metrics_port, workers, nworkers) == 0;
+    if (!ok) {
+        for (int i = 0; i < nworkers && workers[i] != NULL; i++) {
+            fleet_worker_cleanup(workers[i]);
+            free(workers[i]);
+        }
+        wolfSSL_Cleanup();
+        return 1;
+    }
+    printf("[Init] ✓ Server initialization complete\n\n");
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    for (int i = 0; i < ncrypto; i++) {
+        if (pthread_create(&g_pool.tids[i], NULL, crypto_thread, NULL) != 0)
+            break;
+        g_pool.nthreads++;
+    }
+
+    /* Worker 0 runs on the main thread. */
+    for (int i = 1; i < nworkers; i++)
+        pthread_create(&workers[i]->tid, NULL, fleet_worker_run, workers[i]);
+    fleet_worker_run(workers[0]);
+    for (int i = 1; i < nworkers; i++)
+        pthread_join(workers[i]->tid, NULL);
+
+    /* Let queued jobs finish; their sessions are freed with the workers. */
+    pthread_mutex_lock(&g_pool.lock);
+    g_pool.stop = 1;
+    pthread_cond_broadcast(&g_pool.cond);
+    pthread_mutex_unlock(&g_pool.lock);
+    for (int i = 0; i < g_pool.nthreads; i++)
+        pthread_join(g_pool.tids[i], NULL);
+    if (g_metrics.sock >= 0) {
+        pthread_join(g_metrics.tid, NULL);
+        close(g_metrics.sock);
+    }
+
+    printf("\n=== Shutting Down ===\n");
+    for (int i = 0; i < nworkers; i++) {
+        fleet_t* f = workers[i];
+        printf("[Stats] worker %d: handshakes=%lu cookies_sent=%lu cookies_skipped=%lu "
+               "cookie_rejects=%lu dropped=%lu handoffs=%lu active=%d\n",
+               i, f->handshakes, f->cookies_sent, f->cookies_skipped, f->cookie_rejects,
+               f->dropped, f->handoffs, f->count);
+        printf("[Stats] worker %d: rx %lu datagrams / %lu recvmmsg, tx %lu datagrams / %lu sendmmsg\n",
+               i, f->rx_datagrams, f->rx_calls, f->tx_datagrams + f->tx_direct,
+               f->tx_calls + f->tx_direct);
+        printf("[Stats] worker %d: retransmit timeouts=%lu aead_failures=%lu replay_drops=%lu "
+               "handshake failures=%lu\n",
+               i, f->retransmits, f->aead_failures, f->replay_drops, f->hs_failures);
+        if (f->offload)
+            printf("[Stats] worker %d: %lu handshake steps offloaded\n", i, f->offloaded);
+        unsigned long full = f->handshakes - f->resumed;
+        double full_ms = full ? (double)f->full_cpu_ns / 1e6 / (double)full : 0.0;
+        double res_ms = f->resumed ? (double)f->resumed_cpu_ns / 1e6 / (double)f->resumed : 0.0;
+        printf("[Stats] worker %d: resumed %lu/%lu (%.1f%%), CPU per handshake full %.2f ms, "
+               "resumed %.2f ms (%.0f%% saved)\n",
+               i, f->resumed, f->handshakes,
+               f->handshakes ? 100.0 * (double)f->resumed / (double)f->handshakes : 0.0,
+               full_ms, res_ms, full_ms > 0 && f->resumed ? 100.0 * (1.0 - res_ms / full_ms) : 0.0);
+        fleet_worker_cleanup(f);
+        free(f);
+    }
+#ifdef HAVE_SESSION_TICKET
+    if (g_tickets.rotate_s > 0) {
+        printf("[Stats] tickets: issued=%lu opened=%lu (current key) + %lu (retired key) rejected=%lu\n",
+               g_tickets.issued, g_tickets.opened, g_tickets.refreshed, g_tickets.rejected);
+        wc_FreeRng(&g_tickets.rng);
+    }
+#endif
+    wc_FreeRng(&g_cookies.rng);
+#ifdef FLEET_SHM_CACHE
+    if (g_shm != NULL) {
+        unsigned long long hits = g_shm->hits, misses = g_shm->misses;
+        printf("[Stats] session cache (all processes): hits=%llu misses=%llu (%.1f%% hit) "
+               "stores=%llu evictions=%llu oversize=%llu\n",
+               hits, misses, hits + misses ? 100.0 * (double)hits / (double)(hits + misses) : 0.0,
+               g_shm->stores, g_shm->evictions, g_shm->oversize);
+        munmap(g_shm, sizeof(*g_shm));
+    }
+#endif
+    wolfSSL_Cleanup();
+    printf("[Cleanup] ✓ Server shutdown complete\n");
+    return 0;
+}
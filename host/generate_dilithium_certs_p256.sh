@@ -79,6 +79,15 @@ openssl x509 -in client-cert.pem -outform DER -out client-cert.der
 openssl ec -in server-key.pem -outform DER -out server-key.der
 openssl ec -in client-key.pem -outform DER -out client-key.der
 
+# Raw public keys (RFC 7250): the bare SubjectPublicKeyInfo of each key.
+# rpk-allow.pem is the server's device allow-list, one PEM key per device.
+echo "[5/5] Extracting raw public keys..."
+for side in server client; do
+    openssl pkey -in $side-key.pem -pubout -out $side-rpk.pem
+    openssl pkey -pubin -in $side-rpk.pem -outform DER -out $side-rpk.der
+done
+cp client-rpk.pem rpk-allow.pem
+
 echo ""
 echo "=== Certificate Generation Complete ==="
 echo "Certificates stored in: $CERT_DIR"
@@ -3,6 +3,7 @@
 #ifndef __MODULE_H_
 #define __MODULE_H_
 
+#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "pads.h"
@@ -34,6 +35,16 @@ struct ext_module_s {
   int (*add_pads)(void *, struct pad_list_s *);
   int (*close)(void*);
   int (*tick)(void*, uint64_t);
+  /* Optional fast-forward hook: return non-zero when the session has no
+   * work before *until_ps. The core then stops ticking it until that time,
+   * or until the byte pointed to by *wake (if set) becomes non-zero, in
+   * which case it is ticked again on that very step. While every session
+   * is idle the core also skips the model eval. */
+  int (*idle)(void*, uint64_t, uint64_t *, char **);
+  /* Optional snapshot hooks: serialize/restore the session state that is
+   * not part of the Verilated model (buffers, queued frames, ...). */
+  int (*save)(void*, FILE *);
+  int (*restore)(void*, FILE *);
 };
 
 struct ext_module_list_s {
@@ -46,6 +57,7 @@ typedef struct clk_edge_state {
 } clk_edge_state_t;
 
 int litex_sim_file_parse(char *filename, struct module_s **mod, uint64_t *timebase);
+int litex_sim_module_arg_int(struct module_s *mod, char *arg, int64_t *val);
 int litex_sim_load_ext_modules(struct ext_module_list_s **mlist);
 int litex_sim_find_ext_module(struct ext_module_list_s *first, char *name , struct ext_module_list_s **found);
 
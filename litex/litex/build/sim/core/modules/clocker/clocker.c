@@ -10,6 +10,8 @@ struct session_s {
   char *name;
   uint32_t freq_hz;
   uint16_t phase_deg;
+  uint64_t period_ps;
+  uint64_t phase_shift_ps;
 };
 
 static int litex_sim_module_pads_get( struct pad_s *pads, char *name, void **signal)
@@ -133,6 +135,8 @@ static int clocker_add_pads(void *sess, struct pad_list_s *plist)
   }
 
   s->name = plist->name;
+  s->period_ps = 1000000000000ull / s->freq_hz;
+  s->phase_shift_ps = s->period_ps * s->phase_deg / 360;
   *s->clk=0;
   printf("[clocker] %s: freq_hz=%u, phase_deg=%u\n", s->name, s->freq_hz, s->phase_deg);
 out:
@@ -141,15 +145,11 @@ out:
 
 static int clocker_tick(void *sess, uint64_t time_ps)
 {
-  static const uint64_t ps_in_sec = 1000000000000ull;
   struct session_s *s = (struct session_s*) sess;
 
-  uint64_t period_ps = ps_in_sec / s->freq_hz;
-  uint64_t phase_shift_ps = period_ps * s->phase_deg / 360;
-
   // phase-shifted time relative to start of current period
-  uint64_t rel_time_ps = (time_ps - phase_shift_ps) % period_ps;
-  if (rel_time_ps < (period_ps/2)) {
+  uint64_t rel_time_ps = (time_ps - s->phase_shift_ps) % s->period_ps;
+  if (rel_time_ps < (s->period_ps/2)) {
     *s->clk = 1;
   } else {
     *s->clk = 0;
@@ -158,13 +158,32 @@ static int clocker_tick(void *sess, uint64_t time_ps)
   return 0;
 }
 
+/* The clock pad only changes on the next edge, tell the core when that is
+ * so steps in between can be skipped when nothing else is going on. */
+static int clocker_idle(void *sess, uint64_t time_ps, uint64_t *until_ps, char **wake)
+{
+  struct session_s *s = (struct session_s*) sess;
+  uint64_t rel_time_ps = (time_ps - s->phase_shift_ps) % s->period_ps;
+  char level = rel_time_ps < (s->period_ps/2);
+
+  if (*s->clk != level)
+    return 0;
+
+  if (level)
+    *until_ps = time_ps + s->period_ps/2 - rel_time_ps;
+  else
+    *until_ps = time_ps + s->period_ps - rel_time_ps;
+  return 1;
+}
+
 static struct ext_module_s ext_mod = {
   "clocker",
   clocker_start,
   clocker_new,
   clocker_add_pads,
   NULL,
-  clocker_tick
+  clocker_tick,
+  clocker_idle
 };
 
 int litex_sim_ext_module_init(int (*register_module)(struct ext_module_s *))
@@ -1,6 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "error.h"
 
 #include <event2/listener.h>
@@ -10,10 +13,16 @@
 #include "tapcfg.h"
 #include "modules.h"
 
+#define ETH_LEN 2000
+#define MIN_ETH_LEN 60
+
+/* Number of preallocated RX frame slots, must be a power of two */
+#define ETH_RING_SIZE 64
+#define ETH_RING_MASK (ETH_RING_SIZE - 1)
+
 struct eth_packet_s {
-  char data[2000];
+  char data[ETH_LEN];
   size_t len;
-  struct eth_packet_s *next;
 };
 
 struct session_s {
@@ -26,12 +35,16 @@ struct session_s {
   char *sys_clk;
   tapcfg_t *tapcfg;
   int fd;
-  char databuf[2000];
+  clk_edge_state_t edge;
+  char databuf[ETH_LEN];
   int datalen;
-  char inbuf[2000];
+  struct eth_packet_s *inpack;
   int inlen;
   int insent;
-  struct eth_packet_s *ethpack;
+  /* RX ring (TAP -> Sim): filled at head by event_handler, drained at tail by tick */
+  struct eth_packet_s ring[ETH_RING_SIZE];
+  unsigned int ring_head;
+  unsigned int ring_tail;
   struct event *ev;
 };
 
@@ -108,21 +121,30 @@ void event_handler(int fd, short event, void *arg)
 {
   struct  session_s *s = (struct session_s*)arg;
   struct eth_packet_s *ep;
-  struct eth_packet_s *tep;
-
-  if (event & EV_READ) {
-    ep = malloc(sizeof(struct eth_packet_s));
-    memset(ep, 0, sizeof(struct eth_packet_s));
-    ep->len = tapcfg_read(s->tapcfg, ep->data, 2000);
-    if(ep->len < 60)
-      ep->len = 60;
-
-    if(!s->ethpack)
-      s->ethpack = ep;
-    else {
-      for(tep=s->ethpack; tep->next; tep=tep->next);
-      tep->next = ep;
+  ssize_t len;
+
+  if (!(event & EV_READ))
+    return;
+
+  /* Drain every frame queued on the (non-blocking) TAP fd in one go. If the
+   * ring is full the remaining frames stay in the kernel and the level
+   * triggered event fires again on the next loop iteration. */
+  while(s->ring_head - s->ring_tail < ETH_RING_SIZE) {
+    ep = &s->ring[s->ring_head & ETH_RING_MASK];
+    len = read(fd, ep->data, ETH_LEN);
+    if(len < 0) {
+      if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        fprintf(stderr, "[ethernet] TAP read error: %s\n", strerror(errno));
+      break;
+    }
+    if(len == 0)
+      break;
+    if(len < MIN_ETH_LEN) {
+      memset(&ep->data[len], 0, MIN_ETH_LEN - len);
+      len = MIN_ETH_LEN;
     }
+    ep->len = len;
+    s->ring_head++;
   }
 }
 
@@ -161,6 +183,7 @@ static int ethernet_new(void **sess, char *args)
   s->tapcfg = tapcfg_init();
   tapcfg_start(s->tapcfg, c_tap, 0);
   s->fd = tapcfg_get_fd(s->tapcfg);
+  fcntl(s->fd, F_SETFL, fcntl(s->fd, F_GETFL, 0) | O_NONBLOCK);
   tapcfg_iface_set_hwaddr(s->tapcfg, macadr, 6);
   tapcfg_iface_set_ipv4(s->tapcfg, c_tap_ip, 24);
   tapcfg_iface_set_status(s->tapcfg, TAPCFG_STATUS_ALL_UP);
@@ -202,19 +225,25 @@ out:
 
 static int ethernet_tick(void *sess, uint64_t time_ps)
 {
-  static clk_edge_state_t edge;
   char c;
   struct session_s *s = (struct session_s*)sess;
-  struct eth_packet_s *pep;
 
-  if(!clk_pos_edge(&edge, *s->sys_clk)) {
+  if(!clk_pos_edge(&s->edge, *s->sys_clk)) {
+    return RC_OK;
+  }
+
+  /* Fast path: no frame in flight in either direction */
+  if(!*s->tx_valid && !s->datalen && !s->inlen && s->ring_head == s->ring_tail) {
+    *s->tx_ready = 1;
+    *s->rx_valid = 0;
     return RC_OK;
   }
 
   *s->tx_ready = 1;
   if(*s->tx_valid == 1) {
     c = *s->tx;
-    s->databuf[s->datalen++]=c;
+    if(s->datalen < ETH_LEN)
+      s->databuf[s->datalen++]=c;
   } else {
     if(s->datalen) {
       tapcfg_write(s->tapcfg, s->databuf, s->datalen);
@@ -225,30 +254,98 @@ static int ethernet_tick(void *sess, uint64_t time_ps)
   *s->rx_valid=0;
   if(s->inlen) {
     *s->rx_valid=1;
-    *s->rx = s->inbuf[s->insent++];
+    *s->rx = s->inpack->data[s->insent++];
     if(s->insent == s->inlen) {
       s->insent =0;
       s->inlen = 0;
+      s->ring_tail++;
     }
   } else {
-    if(s->ethpack) {
-      memcpy(s->inbuf, s->ethpack->data, s->ethpack->len);
-      s->inlen = s->ethpack->len;
-      pep=s->ethpack->next;
-      free(s->ethpack);
-      s->ethpack=pep;
+    if(s->ring_head != s->ring_tail) {
+      s->inpack = &s->ring[s->ring_tail & ETH_RING_MASK];
+      s->inlen = s->inpack->len;
     }
   }
   return RC_OK;
 }
 
+static int ethernet_idle(void *sess, uint64_t time_ps, uint64_t *until_ps, char **wake)
+{
+  struct session_s *s = (struct session_s*)sess;
+
+  if(*s->tx_valid || *s->rx_valid || s->datalen || s->inlen || s->ring_head != s->ring_tail)
+    return 0;
+
+  /* Nothing to do until the SoC starts a frame or the TAP delivers one;
+   * the latter is picked up when the core polls us again after libevent
+   * ran. Forget the clock level so the waking edge is seen as rising. */
+  s->edge.last_clk = 0;
+  *until_ps = UINT64_MAX;
+  *wake = s->tx_valid;
+  return 1;
+}
+
+/* The TAP interface itself is recreated by ethernet_new(), only the frames
+ * in flight are part of the snapshot. */
+static int ethernet_save(void *sess, FILE *f)
+{
+  struct session_s *s = (struct session_s*)sess;
+  unsigned int count = s->ring_head - s->ring_tail;
+  unsigned int i;
+  struct eth_packet_s *ep;
+
+  fwrite(&s->edge, sizeof(s->edge), 1, f);
+  fwrite(&s->datalen, sizeof(s->datalen), 1, f);
+  fwrite(s->databuf, 1, s->datalen, f);
+  fwrite(&s->inlen, sizeof(s->inlen), 1, f);
+  fwrite(&s->insent, sizeof(s->insent), 1, f);
+  fwrite(&count, sizeof(count), 1, f);
+  for(i = 0; i < count; i++) {
+    ep = &s->ring[(s->ring_tail + i) & ETH_RING_MASK];
+    fwrite(&ep->len, sizeof(ep->len), 1, f);
+    fwrite(ep->data, 1, ep->len, f);
+  }
+  return ferror(f) ? RC_ERROR : RC_OK;
+}
+
+static int ethernet_restore(void *sess, FILE *f)
+{
+  struct session_s *s = (struct session_s*)sess;
+  unsigned int count;
+  unsigned int i;
+  struct eth_packet_s *ep;
+
+  if(fread(&s->edge, sizeof(s->edge), 1, f) != 1 ||
+     fread(&s->datalen, sizeof(s->datalen), 1, f) != 1 ||
+     s->datalen < 0 || s->datalen > ETH_LEN ||
+     fread(s->databuf, 1, s->datalen, f) != s->datalen ||
+     fread(&s->inlen, sizeof(s->inlen), 1, f) != 1 ||
+     fread(&s->insent, sizeof(s->insent), 1, f) != 1 ||
+     fread(&count, sizeof(count), 1, f) != 1 || count > ETH_RING_SIZE)
+    return RC_ERROR;
+
+  for(i = 0; i < count; i++) {
+    ep = &s->ring[i];
+    if(fread(&ep->len, sizeof(ep->len), 1, f) != 1 || ep->len > ETH_LEN ||
+       fread(ep->data, 1, ep->len, f) != ep->len)
+      return RC_ERROR;
+  }
+  s->ring_tail = 0;
+  s->inpack = &s->ring[0];
+  s->ring_head = count;
+  return RC_OK;
+}
+
 static struct ext_module_s ext_mod = {
   "ethernet",
   ethernet_start,
   ethernet_new,
   ethernet_add_pads,
   NULL,
-  ethernet_tick
+  ethernet_tick,
+  ethernet_idle,
+  ethernet_save,
+  ethernet_restore
 };
 
 int litex_sim_ext_module_init(int (*register_module)(struct ext_module_s *))
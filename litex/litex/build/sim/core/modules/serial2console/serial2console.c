@@ -18,6 +18,7 @@ struct session_s {
   char *rx_valid;
   char *rx_ready;
   char *sys_clk;
+  clk_edge_state_t edge;
   struct event *ev;
   char databuf[2048];
   int data_start;
@@ -141,10 +142,9 @@ out:
 }
 
 static int serial2console_tick(void *sess, uint64_t time_ps) {
-  static clk_edge_state_t edge;
   struct session_s *s = (struct session_s*)sess;
 
-  if(!clk_pos_edge(&edge, *s->sys_clk)) {
+  if(!clk_pos_edge(&s->edge, *s->sys_clk)) {
     return RC_OK;
   }
 
@@ -167,13 +167,57 @@ static int serial2console_tick(void *sess, uint64_t time_ps) {
   return RC_OK;
 }
 
+static int serial2console_idle(void *sess, uint64_t time_ps, uint64_t *until_ps, char **wake)
+{
+  struct session_s *s = (struct session_s*)sess;
+
+  if(*s->tx_valid || *s->rx_valid || s->datalen)
+    return 0;
+
+  s->edge.last_clk = 0;
+  *until_ps = UINT64_MAX;
+  *wake = s->tx_valid;
+  return 1;
+}
+
+static int serial2console_save(void *sess, FILE *f)
+{
+  struct session_s *s = (struct session_s*)sess;
+  unsigned int count = s->datalen;
+  unsigned int i;
+
+  fwrite(&s->edge, sizeof(s->edge), 1, f);
+  fwrite(&count, sizeof(count), 1, f);
+  for(i = 0; i < count; i++)
+    fputc(s->databuf[(s->data_start + i) % 2048], f);
+  return ferror(f) ? RC_ERROR : RC_OK;
+}
+
+static int serial2console_restore(void *sess, FILE *f)
+{
+  struct session_s *s = (struct session_s*)sess;
+  unsigned int count;
+
+  if(fread(&s->edge, sizeof(s->edge), 1, f) != 1 ||
+     fread(&count, sizeof(count), 1, f) != 1 || count > 2048 ||
+     fread(s->databuf, 1, count, f) != count)
+    return RC_ERROR;
+
+  s->data_start = 0;
+  s->datalen = count;
+  return RC_OK;
+}
+
 static struct ext_module_s ext_mod = {
   "serial2console",
   serial2console_start,
   serial2console_new,
   serial2console_add_pads,
   NULL,
-  serial2console_tick
+  serial2console_tick,
+  serial2console_idle,
+  serial2console_save,
+  serial2console_restore
 };
 
 int litex_sim_ext_module_init(int (*register_module) (struct ext_module_s *))
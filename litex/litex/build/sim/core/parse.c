@@ -366,6 +366,34 @@ out:
   return ret;
 }
 
+int litex_sim_module_arg_int(struct module_s *mod, char *arg, int64_t *val)
+{
+  json_object *obj=NULL;
+  json_object *jarg;
+  int ret=RC_OK;
+
+  if(!mod || !arg || !val)
+  {
+    ret = RC_INVARG;
+    eprintf("Invalid argument\n");
+    goto out;
+  }
+
+  if(!mod->args || !(obj = json_tokener_parse(mod->args)) ||
+     !json_object_object_get_ex(obj, arg, &jarg))
+  {
+    ret = RC_JSERROR;
+    goto out;
+  }
+  *val = json_object_get_int64(jarg);
+
+out:
+  if(obj)
+  {
+    json_object_put(obj);
+  }
+  return ret;
+}
 
 int litex_sim_file_parse(char *filename, struct module_s **mod, uint64_t *timebase)
 {
@@ -12,6 +12,8 @@
 #include <sys/socket.h>
 #endif
 #include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
 #include "error.h"
 #include "modules.h"
 #include "pads.h"
@@ -24,15 +26,40 @@
 void litex_sim_init(void **out);
 void litex_sim_dump();
 
+#define SIM_BATCH_STEPS 1000
+/* Tick/eval costs are timed on one step out of SIM_PROFILE_INTERVAL */
+#define SIM_PROFILE_INTERVAL 64
+
+#define SIM_SNAPSHOT_NAME  "sim_snapshot"
+#define SIM_SNAPSHOT_MAGIC 0x4e53584cu /* "LXSN" */
+
+/* Generated in sim_init.cpp from --save-marker / --load-snapshot */
+extern long litex_sim_save_marker;
+extern int litex_sim_load_snapshot;
+
 struct session_list_s {
   void *session;
   char tickfirst;
+  char idle;
+  uint64_t idle_until;
+  char *wake;
+  uint64_t ticks;
+  uint64_t ticks_skipped;
+  uint64_t prof_ticks;
+  uint64_t prof_ns;
   struct ext_module_s *module;
   struct session_list_s *next;
 };
 
 uint64_t timebase_ps = 1;
 uint64_t sim_time_ps = 0;
+uint64_t sim_steps = 0;
+uint64_t sim_steps_skipped = 0;
+/* Set when every session has an idle hook, see litex_sim_skippable() */
+static int sim_skip_ok;
+uint64_t sys_clk_freq_hz = 0;
+uint64_t eval_prof_steps = 0;
+uint64_t eval_prof_ns = 0;
 struct session_list_s *sesslist=NULL;
 struct event_base *base=NULL;
 
@@ -104,6 +131,13 @@ static int litex_sim_initialize_all(void **sim, void *base)
     }
     memset(slist, 0, sizeof(struct session_list_s));
 
+    if(!strcmp(mli->name, "clocker") && mli->niface && !strcmp(mli->iface[0].name, "sys_clk"))
+    {
+      int64_t freq_hz;
+      if(RC_OK == litex_sim_module_arg_int(mli, "freq_hz", &freq_hz))
+        sys_clk_freq_hz = freq_hz;
+    }
+
     slist->tickfirst = mli->tickfirst;
     slist->module = pmlist->module;
     slist->next = sesslist;
@@ -141,6 +175,113 @@ out:
   return ret;
 }
 
+/* Full-system snapshot: the Verilated model goes to SIM_SNAPSHOT_NAME.vlt,
+ * the simulation time and module session state to SIM_SNAPSHOT_NAME.mod.
+ * Sessions are stored in session list order, which only depends on the
+ * configuration, so restoring requires the same sim_config.js. */
+static int litex_sim_snapshot_save(void *vsim)
+{
+  struct session_list_s *s;
+  uint32_t magic = SIM_SNAPSHOT_MAGIC;
+  uint32_t len;
+  FILE *f=NULL;
+  int ret = RC_OK;
+
+  if(litex_sim_save_snapshot(vsim, SIM_SNAPSHOT_NAME ".vlt"))
+  {
+    eprintf("Snapshots need a savable build (--save-marker/--load-snapshot)\n");
+    ret = RC_ERROR;
+    goto out;
+  }
+
+  f = fopen(SIM_SNAPSHOT_NAME ".mod", "wb");
+  if(!f)
+  {
+    eprintf("Can't create %s.mod\n", SIM_SNAPSHOT_NAME);
+    ret = RC_ERROR;
+    goto out;
+  }
+  fwrite(&magic, sizeof(magic), 1, f);
+  fwrite(&sim_time_ps, sizeof(sim_time_ps), 1, f);
+  for(s = sesslist; s; s=s->next)
+  {
+    len = strlen(s->module->name);
+    fwrite(&len, sizeof(len), 1, f);
+    fwrite(s->module->name, len, 1, f);
+    if(s->module->save && RC_OK != (ret = s->module->save(s->session, f)))
+    {
+      eprintf("Module %s failed to save its state\n", s->module->name);
+      goto out;
+    }
+  }
+  printf("\n[sim] snapshot saved at %llu ps\n", (unsigned long long)sim_time_ps);
+
+out:
+  if(f)
+    fclose(f);
+  return ret;
+}
+
+static int litex_sim_snapshot_restore(void *vsim)
+{
+  struct session_list_s *s;
+  uint32_t magic = 0;
+  uint32_t len;
+  char name[256];
+  FILE *f=NULL;
+  int ret = RC_OK;
+
+  f = fopen(SIM_SNAPSHOT_NAME ".mod", "rb");
+  if(!f)
+  {
+    eprintf("Can't open %s.mod\n", SIM_SNAPSHOT_NAME);
+    ret = RC_ERROR;
+    goto out;
+  }
+  if(fread(&magic, sizeof(magic), 1, f) != 1 || magic != SIM_SNAPSHOT_MAGIC ||
+     fread(&sim_time_ps, sizeof(sim_time_ps), 1, f) != 1)
+  {
+    eprintf("Invalid snapshot %s.mod\n", SIM_SNAPSHOT_NAME);
+    ret = RC_ERROR;
+    goto out;
+  }
+  for(s = sesslist; s; s=s->next)
+  {
+    if(fread(&len, sizeof(len), 1, f) != 1 || len >= sizeof(name) ||
+       fread(name, len, 1, f) != 1)
+    {
+      eprintf("Truncated snapshot %s.mod\n", SIM_SNAPSHOT_NAME);
+      ret = RC_ERROR;
+      goto out;
+    }
+    name[len] = 0;
+    if(strcmp(name, s->module->name))
+    {
+      eprintf("Snapshot has module %s where %s is configured\n", name, s->module->name);
+      ret = RC_ERROR;
+      goto out;
+    }
+    if(s->module->restore && RC_OK != (ret = s->module->restore(s->session, f)))
+    {
+      eprintf("Module %s failed to restore its state\n", s->module->name);
+      goto out;
+    }
+  }
+
+  if(litex_sim_restore_snapshot(vsim, SIM_SNAPSHOT_NAME ".vlt"))
+  {
+    eprintf("Snapshots need a savable build (--save-marker/--load-snapshot)\n");
+    ret = RC_ERROR;
+    goto out;
+  }
+  printf("[sim] snapshot restored at %llu ps\n", (unsigned long long)sim_time_ps);
+
+out:
+  if(f)
+    fclose(f);
+  return ret;
+}
+
 int litex_sim_sort_session()
 {
   struct session_list_s *s;
@@ -169,38 +310,167 @@ int litex_sim_sort_session()
 
 struct event *ev;
 
-static void cb(int sock, short which, void *arg)
+/* Ask every session with an idle hook whether it can be left alone for a
+ * while. Done once per batch, after libevent had a chance to deliver
+ * external input (TAP frames, console keys) to the modules. */
+static void litex_sim_update_idle(void)
 {
   struct session_list_s *s;
-  void *vsim=arg;
-  struct timeval tv;
-  tv.tv_sec = 0;
-  tv.tv_usec = 0;
+
+  sim_skip_ok = 1;
+  for(s = sesslist; s; s=s->next)
+  {
+    s->idle = 0;
+    if(!s->module->idle)
+    {
+      sim_skip_ok = 0;
+      continue;
+    }
+    s->idle_until = UINT64_MAX;
+    s->wake = NULL;
+    if(s->module->idle(s->session, sim_time_ps, &s->idle_until, &s->wake))
+      s->idle = (s->idle_until > sim_time_ps);
+  }
+}
+
+/* When every session is idle the model inputs cannot change, so the steps
+ * up to the earliest idle_until need neither ticks nor an eval. Returns how
+ * many steps (at most max_steps) can be skipped from sim_time_ps on. Sessions
+ * that went busy earlier in the batch are asked again, so the clocker
+ * reports its next edge each time. */
+static uint64_t litex_sim_skippable(uint64_t max_steps)
+{
+  struct session_list_s *s;
+  uint64_t until = UINT64_MAX;
+
+  for(s = sesslist; s; s=s->next)
+  {
+    if(!s->idle)
+    {
+      s->idle_until = UINT64_MAX;
+      s->wake = NULL;
+      if(!s->module->idle(s->session, sim_time_ps, &s->idle_until, &s->wake))
+        return 0;
+      s->idle = (s->idle_until > sim_time_ps);
+    }
+    if(!s->idle || sim_time_ps >= s->idle_until || (s->wake && *s->wake))
+      return 0;
+    if(s->idle_until < until)
+      until = s->idle_until;
+  }
+  if(until == UINT64_MAX)
+    return max_steps;
+  /* Land on the step at or after the earliest wake up time */
+  until = (until - sim_time_ps + timebase_ps - 1) / timebase_ps;
+  return until < max_steps ? until : max_steps;
+}
+
+static inline uint64_t litex_sim_now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline void litex_sim_tick_session(struct session_list_s *s, int profile)
+{
+  uint64_t t0;
+
+  if(s->idle)
+  {
+    if(sim_time_ps < s->idle_until && !(s->wake && *s->wake))
+    {
+      s->ticks_skipped++;
+      return;
+    }
+    s->idle = 0;
+  }
+  s->ticks++;
+  if(!profile)
+  {
+    s->module->tick(s->session, sim_time_ps);
+    return;
+  }
+  t0 = litex_sim_now_ns();
+  s->module->tick(s->session, sim_time_ps);
+  s->prof_ns += litex_sim_now_ns() - t0;
+  s->prof_ticks++;
+}
+
+/* Run one batch of simulation steps, returns non-zero once the model
+ * called $finish. */
+static int litex_sim_run_batch(void *vsim)
+{
+  struct session_list_s *s;
+  uint64_t t0 = 0;
+  uint64_t skip;
+  int profile;
   int i;
 
-  for(i = 0; i < 1000; i++)
+  litex_sim_update_idle();
+
+  for(i = 0; i < SIM_BATCH_STEPS; i++)
   {
+    if(sim_skip_ok && (skip = litex_sim_skippable(SIM_BATCH_STEPS - i)))
+    {
+      for(s = sesslist; s; s=s->next)
+        s->ticks_skipped += skip;
+      sim_time_ps += skip * timebase_ps;
+      sim_steps += skip;
+      sim_steps_skipped += skip;
+      i += skip - 1;
+      continue;
+    }
+
+    profile = (sim_steps % SIM_PROFILE_INTERVAL) == 0;
+
     for(s = sesslist; s; s=s->next)
     {
       if(s->tickfirst)
-        s->module->tick(s->session, sim_time_ps);
+        litex_sim_tick_session(s, profile);
     }
 
+    if(profile)
+      t0 = litex_sim_now_ns();
     litex_sim_eval(vsim, sim_time_ps);
+    if(profile)
+    {
+      eval_prof_ns += litex_sim_now_ns() - t0;
+      eval_prof_steps++;
+    }
     litex_sim_dump();
 
     for(s = sesslist; s; s=s->next)
     {
       if(!s->tickfirst)
-        s->module->tick(s->session, sim_time_ps);
+        litex_sim_tick_session(s, profile);
     }
 
     sim_time_ps += timebase_ps;
+    sim_steps++;
 
-    if (litex_sim_got_finish()) {
-        event_base_loopbreak(base);
-        break;
+    if (litex_sim_save_marker >= 0 && litex_sim_get_marker() == litex_sim_save_marker) {
+      litex_sim_snapshot_save(vsim);
+      litex_sim_save_marker = -1;
     }
+
+    if (litex_sim_got_finish())
+      return 1;
+  }
+  return 0;
+}
+
+static void cb(int sock, short which, void *arg)
+{
+  void *vsim=arg;
+  struct timeval tv;
+  tv.tv_sec = 0;
+  tv.tv_usec = 0;
+
+  if (litex_sim_run_batch(vsim)) {
+    event_base_loopbreak(base);
+    return;
   }
 
   if (!evtimer_pending(ev, NULL)) {
@@ -209,9 +479,50 @@ static void cb(int sock, short which, void *arg)
   }
 }
 
+/* Printed once the simulation is over: how much SoC time this run
+ * simulated (from start_ps, after any snapshot restore), how fast, and
+ * where the host time went. Per-step costs are sampled. */
+static void litex_sim_report_perf(uint64_t start_ns, uint64_t start_ps)
+{
+  struct session_list_s *s;
+  double wall_s;
+  double sim_s;
+  double tick_ns;
+  uint64_t cycles;
+
+  wall_s = (litex_sim_now_ns() - start_ns) / 1e9;
+  if(wall_s <= 0)
+    return;
+  sim_s = (sim_time_ps - start_ps) / 1e12;
+  /* Without a sys_clk clocker, assume two timebase steps per clock period */
+  cycles = sys_clk_freq_hz ? (uint64_t)(sim_s * sys_clk_freq_hz) : sim_steps / 2;
+
+  printf("\n[sim] ---- performance report ----\n");
+  printf("[sim] sys_clk %llu Hz, timebase %llu ps, %llu steps (%llu without eval)\n",
+         (unsigned long long)sys_clk_freq_hz, (unsigned long long)timebase_ps,
+         (unsigned long long)sim_steps, (unsigned long long)sim_steps_skipped);
+  printf("[sim] simulated %llu cycles (%.6f s of SoC time) in %.3f s wall\n",
+         (unsigned long long)cycles, sim_s, wall_s);
+  printf("[sim] speed %.3f kHz (%.6fx real time)\n",
+         cycles / wall_s / 1e3, sim_s / wall_s);
+  if(eval_prof_steps)
+    printf("[sim] %-16s %8.1f ns/step\n", "model eval",
+           (double)eval_prof_ns / eval_prof_steps);
+  for(s = sesslist; s; s=s->next)
+  {
+    tick_ns = s->prof_ticks ? (double)s->prof_ns / s->prof_ticks : 0.0;
+    printf("[sim] %-16s %8.1f ns/tick, %llu ticks, %llu skipped, ~%.3f s total\n",
+           s->module->name, tick_ns,
+           (unsigned long long)s->ticks, (unsigned long long)s->ticks_skipped,
+           tick_ns * s->ticks / 1e9);
+  }
+}
+
 int main(int argc, char *argv[])
 {
   void *vsim=NULL;
+  uint64_t wall_start;
+  uint64_t sim_start;
   struct timeval tv;
 
   int ret;
@@ -221,7 +532,6 @@ int main(int argc, char *argv[])
   WSAStartup(0x0201, &wsa_data);
 #endif
 
-
   base = event_base_new();
   if(!base)
   {
@@ -241,11 +551,19 @@ int main(int argc, char *argv[])
     goto out;
   }
 
+  if(litex_sim_load_snapshot && RC_OK != (ret = litex_sim_snapshot_restore(vsim)))
+  {
+    goto out;
+  }
+
+  wall_start = litex_sim_now_ns();
+  sim_start = sim_time_ps;
   tv.tv_sec = 0;
   tv.tv_usec = 0;
   ev = event_new(base, -1, EV_PERSIST, cb, vsim);
   event_add(ev, &tv);
   event_base_dispatch(base);
+  litex_sim_report_perf(wall_start, sim_start);
 #if VM_COVERAGE
   litex_sim_coverage_dump();
 #endif
@@ -99,6 +99,31 @@ static void litex_sim_restore_state(void *vsim,const char* filename) {
 }
 #endif
 
+extern "C" int litex_sim_save_snapshot(void *vsim, const char *filename)
+{
+#ifdef SAVABLE
+  litex_sim_save_state(vsim, filename);
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+extern "C" int litex_sim_restore_snapshot(void *vsim, const char *filename)
+{
+#ifdef SAVABLE
+  litex_sim_restore_state(vsim, filename);
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+extern "C" int litex_sim_get_marker()
+{
+  return g_sim != nullptr ? g_sim->sim_marker : 0;
+}
+
 
 extern "C" void litex_sim_tracer_dump()
 {
@@ -22,6 +22,8 @@ class SimPlatform(GenericPlatform):
     def __init__(self, device, io, name="sim", toolchain="verilator", **kwargs):
         if "sim_trace" not in (iface[0] for iface in io):
             io.append(("sim_trace", 0, Pins(1)))
+        if "sim_marker" not in (iface[0] for iface in io):
+            io.append(("sim_marker", 0, Pins(8)))
         GenericPlatform.__init__(self, device, io, name=name, **kwargs)
         self.sim_requested = []
         if toolchain == "verilator":
@@ -30,6 +32,8 @@ class SimPlatform(GenericPlatform):
             raise ValueError(f"Unknown toolchain {toolchain}")
         # we must always request the sim_trace signal
         self.trace = self.request("sim_trace")
+        # and the marker, used by the simulator to trigger snapshots
+        self.marker = self.request("sim_marker")
 
     def request(self, name, number=None, loose=False):
         index = ""
@@ -58,7 +62,7 @@ class SimPlatform(GenericPlatform):
 
     def add_debug(self, module, reset=0):
         module.submodules.sim_trace = SimTrace(self.trace, reset=reset)
-        module.submodules.sim_marker = SimMarker()
+        module.submodules.sim_marker = SimMarker(self.marker)
         module.submodules.sim_finish = SimFinish()
         self.trace = None
 
@@ -108,10 +112,14 @@ class SimMarker(Module, AutoCSR):
 
     This is useful when analysing trace dumps. Change the marker value from
     software/gateware, and then check the *_marker_storage signal in GTKWave.
+    The simulator also watches the marker to save snapshots (--save-marker).
     """
-    def __init__(self, size=8):
+    def __init__(self, pin=None, size=8):
         # set from software
         self.marker = CSRStorage(size)
+        # used by simulator to trigger snapshots
+        if pin is not None:
+            self.comb += pin.eq(self.marker.storage)
 
 class SimFinish(Module, AutoCSR):
     """Finish simulation from software"""
@@ -65,7 +65,8 @@ def _generate_sim_cpp_struct(name, index, siglist):
     return content
 
 
-def _generate_sim_cpp(platform, trace=False, trace_start=0, trace_end=-1, load_start=0, save_start=-1):
+def _generate_sim_cpp(platform, trace=False, trace_start=0, trace_end=-1, load_start=0, save_start=-1,
+    save_marker=-1, load_snapshot=False):
     content = """\
 #include <stdio.h>
 #include <stdlib.h>
@@ -77,9 +78,14 @@ def _generate_sim_cpp(platform, trace=False, trace_start=0, trace_end=-1, load_s
 extern "C" void litex_sim_init_tracer(void *vsim, long start, long end,long load_start, long save_start);
 extern "C" void litex_sim_tracer_dump();
 
+extern "C" {{
+long litex_sim_save_marker = {};
+int litex_sim_load_snapshot = {};
+}}
+
 extern "C" void litex_sim_dump()
-{
-"""
+{{
+""".format(save_marker, int(load_snapshot))
     if trace:
         content += """\
     litex_sim_tracer_dump();
@@ -215,7 +221,9 @@ class SimVerilatorToolchain:
             extra_mods       = None,
             extra_mods_path  = "",
             load_start      = 0,
-            save_start      = -1):
+            save_start      = -1,
+            save_marker     = -1,
+            load_snapshot   = False):
 
         # Create build directory
         os.makedirs(build_dir, exist_ok=True)
@@ -240,7 +248,8 @@ class SimVerilatorToolchain:
 
             # Generate cpp header/main/variables
             _generate_sim_h(platform)
-            _generate_sim_cpp(platform, trace, trace_start, trace_end,load_start, save_start)
+            _generate_sim_cpp(platform, trace, trace_start, trace_end,load_start, save_start,
+                save_marker, load_snapshot)
 
             _generate_sim_variables(platform.verilog_include_paths,
                                     extra_mods,
@@ -252,8 +261,8 @@ class SimVerilatorToolchain:
                 _generate_sim_config(sim_config)
 
             # Build
-            # Set SAVABLE=1 if load_start != 0 and save_start != -1
-            savable = (load_start != 0 or save_start != -1)
+            # Set SAVABLE=1 if load_start != 0 and save_start != -1, or for snapshots
+            savable = (load_start != 0 or save_start != -1 or save_marker >= 0 or load_snapshot)
             _build_sim(
                 build_name = build_name,
                 sources    = platform.sources,
@@ -299,6 +308,8 @@ def verilator_build_args(parser):
     toolchain_group.add_argument("--opt-level",    default="O3",        help="Compilation optimization level.")
     toolchain_group.add_argument("--load-start",    default="0",        help="Time to load s(ps).")
     toolchain_group.add_argument("--save-start",    default="-1",        help="Time to save s(ps).")
+    toolchain_group.add_argument("--save-marker",   default="-1",        help="Save a full-system snapshot when the SimMarker CSR is set to this value (needs --sim-debug).")
+    toolchain_group.add_argument("--load-snapshot", action="store_true", help="Start from the snapshot saved with --save-marker.")
 
 def verilator_build_argdict(args):
     return {
@@ -310,5 +321,7 @@ def verilator_build_argdict(args):
         "trace_end"   : int(float(args.trace_end)),
         "opt_level"   : args.opt_level,
         "load_start" : int(float(args.load_start)),
-        "save_start" : int(float(args.save_start))
+        "save_start" : int(float(args.save_start)),
+        "save_marker"   : int(args.save_marker),
+        "load_snapshot" : args.load_snapshot,
     }
@@ -152,6 +152,7 @@ class Platform(SimPlatform):
 
 class SimSoC(SoCCore):
     def __init__(self,
+        sys_clk_freq           = int(1e6),
         with_sdram             = False,
         with_sdram_bist        = False,
         with_ethernet          = False,
@@ -181,9 +182,6 @@ class SimSoC(SoCCore):
         # Platform ---------------------------------------------------------------------------------
         platform = Platform()
 
-        # Parameters -------------------------------------------------------------------------------
-        sys_clk_freq = int(1e6)
-
         # CRG --------------------------------------------------------------------------------------
         self.crg = CRG(platform.request("sys_clk"))
 
@@ -420,6 +418,9 @@ def generate_gtkw_savefile(builder, vns, trace_fst):
             dfi_group("dfi commands", ["rddata"])
 
 def sim_args(parser):
+    # Clocking.
+    parser.add_argument("--sys-clk-freq",         default=int(1e6),        help="System clock frequency (exported to software as CONFIG_CLOCK_FREQUENCY).")
+
     # ROM / RAM.
     parser.add_argument("--rom-init",             default=None,            help="ROM init file (.bin or .json).")
     parser.add_argument("--ram-init",             default=None,            help="RAM init file (.bin or .json).")
@@ -479,7 +480,7 @@ def main():
 
     soc_kwargs = soc_core_argdict(args)
 
-    sys_clk_freq = int(1e6)
+    sys_clk_freq = int(float(args.sys_clk_freq))
     sim_config   = SimConfig()
     sim_config.add_clocker("sys_clk", freq_hz=sys_clk_freq)
 
@@ -553,6 +554,7 @@ def main():
 
     # SoC ------------------------------------------------------------------------------------------
     soc = SimSoC(
+        sys_clk_freq           = sys_clk_freq,
         with_sdram             = args.with_sdram,
         with_sdram_bist        = args.with_sdram_bist,
         with_ethernet          = args.with_ethernet,